@@ -0,0 +1,403 @@
+/**
+ * @file BitMatrix.hpp
+ * @brief Bit-packed boolean matrix with popcount-based products.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if __has_include(<bit>)
+#include <bit>
+#endif
+
+#if defined(__AVX512VPOPCNTDQ__)
+#include <immintrin.h>
+#endif
+
+#include "Parallel.hpp"
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    namespace detail
+    {
+        /// @brief Number of set bits of a 64-bit word.
+        inline unsigned popcount64(uint64_t word)
+        {
+#if defined(__cpp_lib_bitops)
+            return static_cast<unsigned>(std::popcount(word));
+#else
+            return static_cast<unsigned>(__builtin_popcountll(word));
+#endif
+        }
+
+        /// @brief Index of the lowest set bit of a nonzero 64-bit word.
+        inline size_t lowestBit64(uint64_t word)
+        {
+#if defined(__cpp_lib_bitops)
+            return static_cast<size_t>(std::countr_zero(word));
+#else
+            return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+        }
+
+        /// @brief Word combiner of BitMatrix::intersections(): bits set in both rows.
+        struct AndWords
+        {
+            static uint64_t apply(uint64_t a, uint64_t b) { return a & b; }
+#if defined(__AVX512VPOPCNTDQ__)
+            static __m512i apply(__m512i a, __m512i b) { return _mm512_and_si512(a, b); }
+#endif
+        };
+
+        /// @brief Word combiner of BitMatrix::hammingDistances(): bits that differ.
+        struct XorWords
+        {
+            static uint64_t apply(uint64_t a, uint64_t b) { return a ^ b; }
+#if defined(__AVX512VPOPCNTDQ__)
+            static __m512i apply(__m512i a, __m512i b) { return _mm512_xor_si512(a, b); }
+#endif
+        };
+
+        /**
+         * @brief out[i * ldOut + j] = popcount(Op(a row i, b row j)) for rows [first, last) of a.
+         *
+         * Four rows of a are paired with each row of b at once, so every word
+         * of b loaded serves four counts. With AVX-512 VPOPCNTDQ eight words
+         * are combined and counted per instruction.
+         */
+        template<typename Op>
+        void popcountRows(const uint64_t* a, size_t first, size_t last, const uint64_t* b, size_t rowsB,
+                          size_t words, uint32_t* out, size_t ldOut)
+        {
+            constexpr size_t group = 4;
+            for (size_t i0 = first; i0 < last; i0 += group)
+            {
+                const size_t count = std::min(group, last - i0);
+                const uint64_t* aRows[group];
+                for (size_t r = 0; r < group; ++r)
+                    aRows[r] = a + ((i0 + std::min(r, count - 1)) * words);
+
+                for (size_t j = 0; j < rowsB; ++j)
+                {
+                    const uint64_t* bRow = b + (j * words);
+                    uint64_t sums[group] = {};
+                    size_t w = 0;
+#if defined(__AVX512VPOPCNTDQ__)
+                    __m512i acc[group];
+                    for (size_t r = 0; r < group; ++r)
+                        acc[r] = _mm512_setzero_si512();
+                    for (; w < words; w += 8)
+                    {
+                        const __mmask8 lanes = words - w >= 8 ? __mmask8(0xFF) : __mmask8((1u << (words - w)) - 1);
+                        const __m512i bv = _mm512_maskz_loadu_epi64(lanes, bRow + w);
+                        for (size_t r = 0; r < group; ++r)
+                            acc[r] = _mm512_add_epi64(acc[r], _mm512_popcnt_epi64(
+                                Op::apply(_mm512_maskz_loadu_epi64(lanes, aRows[r] + w), bv)));
+                    }
+                    for (size_t r = 0; r < group; ++r)
+                    {
+                        const __m256i half = _mm256_add_epi64(_mm512_maskz_extracti64x4_epi64(0xF, acc[r], 0),
+                                                              _mm512_maskz_extracti64x4_epi64(0xF, acc[r], 1));
+                        const __m128i quarter = _mm_add_epi64(_mm256_castsi256_si128(half), _mm256_extracti128_si256(half, 1));
+                        sums[r] = static_cast<uint64_t>(_mm_cvtsi128_si64(quarter) + _mm_extract_epi64(quarter, 1));
+                    }
+#endif
+                    for (; w < words; ++w)
+                        for (size_t r = 0; r < group; ++r)
+                            sums[r] += popcount64(Op::apply(aRows[r][w], bRow[w]));
+                    for (size_t r = 0; r < count; ++r)
+                        out[((i0 + r) * ldOut) + j] = static_cast<uint32_t>(sums[r]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Boolean matrix storing one bit per element.
+     *
+     * Tensor<bool> has no contiguous storage (std::vector<bool>), and a Mask
+     * spends a byte per element. Here each row is packed into 64-bit words,
+     * 8x smaller than a Mask, and the products work on whole words: the
+     * boolean product ORs rows together and the similarity kernels count bits
+     * of AND / XOR combinations with popcount. Bits past colCount() in the
+     * last word of a row are kept at zero.
+     */
+    class BitMatrix
+    {
+    private:
+        size_t rows, cols;             ///< Number of rows and columns.
+        size_t words;                  ///< 64-bit words per row.
+        std::vector<uint64_t> bits;    ///< Row-major words, bit j % 64 of word j / 64 is column j.
+
+        void checkIndex(size_t i, size_t j) const
+        {
+            if (i >= rows || j >= cols)
+                TENSOR_THROW(std::out_of_range, "Index out of range: (" + std::to_string(i) + ", " + std::to_string(j) + ")");
+        }
+
+        /// @brief Fills out (rows x other.rows) with popcount(Op(row i, other row j)).
+        template<typename Op>
+        Tensor<uint32_t, RowMajor> popcountProduct(const BitMatrix& other) const
+        {
+            if (cols != other.cols)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            Tensor<uint32_t, RowMajor> result(rows, other.rows);
+            uint32_t* out = detail::TensorAccess::storage(result);
+            const size_t ldOut = detail::TensorAccess::leadingDim(result);
+            auto rowRange = [&](size_t first, size_t last)
+            {
+                detail::popcountRows<Op>(bits.data(), first, last, other.bits.data(), other.rows, words, out, ldOut);
+            };
+            if (rows * other.rows * words >= config::parallelThreshold)
+                detail::parallelFor(rows, 4, rowRange);
+            else
+                rowRange(0, rows);
+            return result;
+        }
+
+    public:
+        /**
+         * @brief Creates an all-false matrix.
+         *
+         * @param rows Number of rows.
+         * @param cols Number of columns.
+         * @throws std::invalid_argument if either dimension is zero.
+         */
+        BitMatrix(size_t rows, size_t cols)
+            : rows(rows), cols(cols), words((cols + 63) / 64), bits(rows * ((cols + 63) / 64), 0)
+        {
+            if (rows == 0 || cols == 0)
+                TENSOR_THROW(std::invalid_argument, "Size can't be 0");
+        }
+
+        /**
+         * @brief Packs a tensor, mapping nonzero elements to true.
+         *
+         * @param source Matrix to pack.
+         * @return The packed matrix.
+         */
+        template<typename T, typename Layout>
+        static BitMatrix fromTensor(const Tensor<T, Layout>& source)
+        {
+            BitMatrix result(source.rowCount(), source.colCount());
+            const T* values = detail::TensorAccess::storage(source);
+            const size_t ld = detail::TensorAccess::leadingDim(source);
+            for (size_t i = 0; i < result.rows; ++i)
+            {
+                uint64_t* row = result.bits.data() + (i * result.words);
+                for (size_t j = 0; j < result.cols; ++j)
+                    row[j / 64] |= uint64_t{values[Layout::offset(i, j, ld)] != T{}} << (j % 64);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Unpacks into a tensor of 0s and 1s.
+         *
+         * @return Tensor with 1 where this matrix is true.
+         */
+        template<typename T, typename Layout = RowMajor>
+        Tensor<T, Layout> toTensor() const
+        {
+            Tensor<T, Layout> result(rows, cols);
+            T* values = detail::TensorAccess::storage(result);
+            const size_t ld = detail::TensorAccess::leadingDim(result);
+            for (size_t i = 0; i < rows; ++i)
+                for (size_t j = 0; j < cols; ++j)
+                    values[Layout::offset(i, j, ld)] = static_cast<T>((bits[(i * words) + (j / 64)] >> (j % 64)) & 1);
+            return result;
+        }
+
+        /**
+         * @brief Returns the number of rows.
+         *
+         * @return Number of rows.
+         */
+        constexpr size_t rowCount() const { return rows; }
+
+        /**
+         * @brief Returns the number of columns.
+         *
+         * @return Number of columns.
+         */
+        constexpr size_t colCount() const { return cols; }
+
+        /**
+         * @brief Returns the number of 64-bit words per row.
+         *
+         * @return Words per row.
+         */
+        constexpr size_t wordCount() const { return words; }
+
+        /**
+         * @brief Returns the packed words of row i; bits past colCount() are zero.
+         *
+         * @param i Row index.
+         * @return Pointer to wordCount() words.
+         * @throws std::out_of_range on an invalid row.
+         */
+        const uint64_t* row(size_t i) const
+        {
+            checkIndex(i, 0);
+            return bits.data() + (i * words);
+        }
+
+        /**
+         * @brief Reads the element at position (i, j).
+         *
+         * @param i Row index.
+         * @param j Column index.
+         * @return The element.
+         * @throws std::out_of_range on invalid indices.
+         */
+        bool operator()(size_t i, size_t j) const
+        {
+            checkIndex(i, j);
+            return (bits[(i * words) + (j / 64)] >> (j % 64)) & 1;
+        }
+
+        /**
+         * @brief Writes the element at position (i, j).
+         *
+         * @param i Row index.
+         * @param j Column index.
+         * @param value The value to store.
+         * @throws std::out_of_range on invalid indices.
+         */
+        void set(size_t i, size_t j, bool value)
+        {
+            checkIndex(i, j);
+            uint64_t& word = bits[(i * words) + (j / 64)];
+            const uint64_t bit = uint64_t{1} << (j % 64);
+            word = value ? (word | bit) : (word & ~bit);
+        }
+
+        /**
+         * @brief Checks equality with another matrix.
+         *
+         * @param other Matrix to compare with.
+         * @return true if shapes and all elements match.
+         */
+        bool operator==(const BitMatrix& other) const
+        {
+            return rows == other.rows && cols == other.cols && bits == other.bits;
+        }
+
+        /**
+         * @brief Checks inequality with another matrix.
+         *
+         * @param other Matrix to compare with.
+         * @return true if shapes or any element differ.
+         */
+        bool operator!=(const BitMatrix& other) const { return !(*this == other); }
+
+        /**
+         * @brief Counts the true elements.
+         *
+         * @return Number of set bits.
+         */
+        size_t count() const
+        {
+            size_t total = 0;
+            for (uint64_t word : bits)
+                total += detail::popcount64(word);
+            return total;
+        }
+
+        /**
+         * @brief Returns the transposed matrix.
+         *
+         * @return Transposed matrix.
+         */
+        BitMatrix transpose() const
+        {
+            BitMatrix result(cols, rows);
+            for (size_t i = 0; i < rows; ++i)
+                for (size_t w = 0; w < words; ++w)
+                    for (uint64_t word = bits[(i * words) + w]; word != 0; word &= word - 1)
+                    {
+                        const size_t j = (w * 64) + detail::lowestBit64(word);
+                        result.bits[(j * result.words) + (i / 64)] |= uint64_t{1} << (i % 64);
+                    }
+            return result;
+        }
+
+        /**
+         * @brief Boolean (or, and) product: C(i, j) = 1 if some A(i, k) = B(k, j) = 1.
+         *
+         * Row i of C is the OR of the rows of B selected by the set bits of
+         * row i of A, so the cost is O(M * nnz-per-row * N / 64) word
+         * operations; one step of a reachability or transitive-closure
+         * computation.
+         *
+         * @param other Right operand.
+         * @return Product matrix.
+         * @throws std::runtime_error if dimensions are incompatible.
+         */
+        BitMatrix operator*(const BitMatrix& other) const
+        {
+            if (cols != other.rows)
+                TENSOR_THROW(std::runtime_error, "Matrix dimensions incompatible for multiplication");
+
+            BitMatrix result(rows, other.cols);
+            const size_t outWords = result.words;
+            auto rowRange = [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    uint64_t* out = result.bits.data() + (i * outWords);
+                    for (size_t w = 0; w < words; ++w)
+                        for (uint64_t word = bits[(i * words) + w]; word != 0; word &= word - 1)
+                        {
+                            const size_t k = (w * 64) + detail::lowestBit64(word);
+                            const uint64_t* in = other.bits.data() + (k * outWords);
+                            for (size_t v = 0; v < outWords; ++v)
+                                out[v] |= in[v];
+                        }
+                }
+            };
+            if (rows * cols * outWords >= config::parallelThreshold)
+                detail::parallelFor(rows, 1, rowRange);
+            else
+                rowRange(0, rows);
+            return result;
+        }
+
+        /**
+         * @brief Counts shared true elements between every pair of rows: C(i, j) = |row i AND other row j|.
+         *
+         * This is the integer product A * B^T of the 0/1 matrices, the
+         * numerator of Jaccard or cosine similarity between binary feature rows.
+         *
+         * @param other Matrix with the same column count.
+         * @return rowCount() x other.rowCount() counts.
+         * @throws std::runtime_error if the column counts differ.
+         */
+        Tensor<uint32_t, RowMajor> intersections(const BitMatrix& other) const
+        {
+            return popcountProduct<detail::AndWords>(other);
+        }
+
+        /**
+         * @brief Hamming distance between every pair of rows: C(i, j) = |row i XOR other row j|.
+         *
+         * @param other Matrix with the same column count.
+         * @return rowCount() x other.rowCount() distances.
+         * @throws std::runtime_error if the column counts differ.
+         */
+        Tensor<uint32_t, RowMajor> hammingDistances(const BitMatrix& other) const
+        {
+            return popcountProduct<detail::XorWords>(other);
+        }
+    };
+}
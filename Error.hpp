@@ -0,0 +1,194 @@
+/**
+ * @file Error.hpp
+ * @brief Error codes for the non-throwing API and the exception-free build mode.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+/**
+ * @brief Raises Exception(message), or reports message and aborts when built with -fno-exceptions.
+ *
+ * Every error in the library goes through this macro, so the headers compile
+ * without exception support; code that must not abort uses the try* members
+ * of Tensor, which report an ErrorCode instead.
+ */
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define TENSOR_THROW(Exception, message) throw Exception(message)
+#else
+#define TENSOR_THROW(Exception, message) ::Tensor::detail::fatal(message)
+#endif
+
+namespace Tensor
+{
+    /**
+     * @brief Reasons an operation can fail, one per exception message of the throwing API.
+     */
+    enum class ErrorCode
+    {
+        ZeroSize,                  ///< A dimension is zero (std::invalid_argument).
+        OutOfRange,                ///< An index is past the end (std::out_of_range).
+        SizeMismatch,              ///< Operands differ in shape (std::runtime_error).
+        IncompatibleDimensions,    ///< Inner dimensions of a product differ (std::runtime_error).
+        AliasedResult              ///< An output aliases an input (std::invalid_argument).
+    };
+
+    /**
+     * @brief Returns the message the throwing API uses for an error.
+     *
+     * @param code Error code.
+     * @return Static, null-terminated description.
+     */
+    constexpr const char* describe(ErrorCode code)
+    {
+        switch (code)
+        {
+            case ErrorCode::ZeroSize: return "Size can't be 0";
+            case ErrorCode::OutOfRange: return "Index out of range";
+            case ErrorCode::SizeMismatch: return "Size mismatch";
+            case ErrorCode::IncompatibleDimensions: return "Matrix dimensions incompatible for multiplication";
+            case ErrorCode::AliasedResult: return "Result can't alias an operand";
+        }
+        return "Unknown error";
+    }
+
+    namespace config
+    {
+        /**
+         * @brief Called with the message of an error in builds without exceptions, before aborting.
+         *
+         * Defaults to printing the message to stderr.
+         */
+        inline void (*fatalHandler)(const char* message) = nullptr;
+    }
+
+    namespace detail
+    {
+        /// @brief Reports an error through config::fatalHandler (or stderr) and aborts.
+        [[noreturn]] inline void fatal(const std::string& message)
+        {
+            if (config::fatalHandler)
+                config::fatalHandler(message.c_str());
+            else
+                std::fprintf(stderr, "Tensor: %s\n", message.c_str());
+            std::abort();
+        }
+    }
+
+#if defined(__cpp_lib_expected)
+    /**
+     * @brief Outcome of a try* operation: a V, or the ErrorCode it failed with.
+     */
+    template<typename V>
+    using Result = std::expected<V, ErrorCode>;
+
+    /// @brief The failed Result for an error code.
+    inline std::unexpected<ErrorCode> failure(ErrorCode code)
+    {
+        return std::unexpected<ErrorCode>(code);
+    }
+#else
+    /// @brief The error alternative of a Result, see failure().
+    struct Failure
+    {
+        ErrorCode code;
+    };
+
+    /// @brief The failed Result for an error code.
+    inline Failure failure(ErrorCode code)
+    {
+        return {code};
+    }
+
+    /**
+     * @brief Outcome of a try* operation: a V, or the ErrorCode it failed with.
+     *
+     * Stands in for std::expected<V, ErrorCode> before C++23 with the subset
+     * of its interface the library's callers need. value() on a failure
+     * raises std::logic_error rather than std::bad_expected_access.
+     */
+    template<typename V>
+    class Result
+    {
+    private:
+        std::optional<V> stored;
+        ErrorCode code{};
+
+    public:
+        Result(V value) : stored(std::move(value)) {}
+        Result(Failure failed) : code(failed.code) {}
+
+        bool has_value() const noexcept { return stored.has_value(); }
+        explicit operator bool() const noexcept { return has_value(); }
+
+        V& value() &
+        {
+            if (!stored)
+                TENSOR_THROW(std::logic_error, describe(code));
+            return *stored;
+        }
+
+        const V& value() const &
+        {
+            if (!stored)
+                TENSOR_THROW(std::logic_error, describe(code));
+            return *stored;
+        }
+
+        V&& value() &&
+        {
+            if (!stored)
+                TENSOR_THROW(std::logic_error, describe(code));
+            return std::move(*stored);
+        }
+
+        template<typename U>
+        V value_or(U&& fallback) const { return stored ? *stored : static_cast<V>(std::forward<U>(fallback)); }
+
+        /// @brief The error; only meaningful when !has_value().
+        ErrorCode error() const noexcept { return code; }
+
+        V& operator*() & { return *stored; }
+        const V& operator*() const & { return *stored; }
+        V* operator->() { return &*stored; }
+        const V* operator->() const { return &*stored; }
+    };
+
+    /// @brief Result of an operation with nothing to return but success.
+    template<>
+    class Result<void>
+    {
+    private:
+        bool succeeded = true;
+        ErrorCode code{};
+
+    public:
+        Result() = default;
+        Result(Failure failed) : succeeded(false), code(failed.code) {}
+
+        bool has_value() const noexcept { return succeeded; }
+        explicit operator bool() const noexcept { return succeeded; }
+
+        void value() const
+        {
+            if (!succeeded)
+                TENSOR_THROW(std::logic_error, describe(code));
+        }
+
+        /// @brief The error; only meaningful when !has_value().
+        ErrorCode error() const noexcept { return code; }
+    };
+#endif
+}
@@ -0,0 +1,731 @@
+/**
+ * @file Factorization.hpp
+ * @brief Dense matrix factorizations and linear solves on Tensor.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    /**
+     * @brief LU factorization with partial pivoting, P * A = L * U.
+     *
+     * L (unit lower) and U share one row-major buffer; row exchanges are
+     * applied physically so the elimination updates stream whole rows.
+     *
+     * @tparam T Floating point type.
+     */
+    template<typename T>
+    class LU
+    {
+        static_assert(std::is_floating_point<T>::value, "LU requires a floating point type");
+
+    private:
+        Tensor<T, RowMajor> lu;        ///< L below the diagonal, U on and above it.
+        std::vector<size_t> perm;      ///< Row i of L * U is row perm[i] of A.
+        bool singular = false;         ///< A zero pivot was met.
+        bool oddSwaps = false;         ///< Parity of the row exchanges, for the determinant.
+
+        /// @brief Largest multiplier an update may leave in L before refactoring; pivoting keeps them at most 1.
+        static constexpr T growthLimit = T{1024};
+
+        /**
+         * @brief Bennett's rank-one update of the factors in f to those of L * U + x * y^T.
+         *
+         * @return false if a pivot cancelled or a multiplier grew past growthLimit; f is then garbage.
+         */
+        static bool rankOne(Tensor<T, RowMajor>& f, std::vector<T>& x, std::vector<T>& y)
+        {
+            const size_t n = f.rows;
+            const size_t ld = f.ld;
+            T* m = f.values.data();
+            const T cancellation = std::sqrt(std::numeric_limits<T>::epsilon());
+            for (size_t i = 0; i < n; ++i)
+            {
+                T* rowI = m + (i * ld);
+                const T term = x[i] * y[i];
+                const T before = rowI[i];
+                rowI[i] += term;
+                if (!(std::abs(rowI[i]) > cancellation * (std::abs(before) + std::abs(term))))
+                    return false;
+                y[i] /= rowI[i];
+                for (size_t j = i + 1; j < n; ++j)
+                {
+                    T& lower = m[(j * ld) + i];
+                    rowI[j] += x[i] * y[j];
+                    x[j] -= x[i] * lower;
+                    y[j] -= y[i] * rowI[j];
+                    lower += y[i] * x[j];
+                    if (std::abs(lower) > growthLimit)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Factors a square matrix.
+         *
+         * @tparam Layout Layout of the input; it is copied to row-major storage.
+         * @param a Matrix to factor.
+         * @throws std::runtime_error if the matrix is not square.
+         */
+        template<typename Layout>
+        explicit LU(const Tensor<T, Layout>& a)
+            : lu(a.template toLayout<RowMajor>()), perm(a.rowCount())
+        {
+            if(a.rowCount() != a.colCount())
+                TENSOR_THROW(std::runtime_error, "Matrix is not square");
+
+            const size_t n = lu.rows;
+            const size_t ld = lu.ld;
+            T* m = lu.values.data();
+            for (size_t i = 0; i < n; ++i)
+                perm[i] = i;
+
+            for (size_t k = 0; k < n; ++k)
+            {
+                size_t pivot = k;
+                for (size_t i = k + 1; i < n; ++i)
+                    if (std::abs(m[(i * ld) + k]) > std::abs(m[(pivot * ld) + k]))
+                        pivot = i;
+
+                if (m[(pivot * ld) + k] == T{0})
+                {
+                    singular = true;
+                    continue;
+                }
+                if (pivot != k)
+                {
+                    std::swap_ranges(m + (k * ld), m + (k * ld) + n, m + (pivot * ld));
+                    std::swap(perm[k], perm[pivot]);
+                    oddSwaps = !oddSwaps;
+                }
+
+                const T* pivotRow = m + (k * ld);
+                for (size_t i = k + 1; i < n; ++i)
+                {
+                    T* row = m + (i * ld);
+                    const T factor = row[k] / pivotRow[k];
+                    row[k] = factor;
+                    for (size_t j = k + 1; j < n; ++j)
+                        row[j] -= factor * pivotRow[j];
+                }
+            }
+        }
+
+        /**
+         * @brief Reports whether a zero pivot was met.
+         *
+         * @return true if the matrix is singular.
+         */
+        bool isSingular() const { return singular; }
+
+        /**
+         * @brief Returns the determinant of the factored matrix.
+         *
+         * @return det(A).
+         */
+        T determinant() const
+        {
+            if (singular)
+                return T{0};
+            T det = oddSwaps ? T{-1} : T{1};
+            for (size_t i = 0; i < lu.rows; ++i)
+                det *= lu.values[lu.index(i, i)];
+            return det;
+        }
+
+        /**
+         * @brief Solves A * X = B.
+         *
+         * @tparam Layout Layout of the right-hand side and result.
+         * @param b Right-hand side with as many rows as A.
+         * @return X.
+         * @throws std::runtime_error if dimensions mismatch or A is singular.
+         */
+        template<typename Layout>
+        Tensor<T, Layout> solve(const Tensor<T, Layout>& b) const
+        {
+            if(b.rowCount() != lu.rows)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+            if (singular)
+                TENSOR_THROW(std::runtime_error, "Matrix is singular");
+
+            const size_t n = lu.rows;
+            const size_t nrhs = b.colCount();
+            const size_t ld = lu.ld;
+            const T* m = lu.values.data();
+
+            Tensor<T, RowMajor> x(n, nrhs);
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < nrhs; ++j)
+                    x.values[x.index(i, j)] = b(perm[i], j);
+
+            T* xs = x.values.data();
+            const size_t ldx = x.ld;
+            for (size_t i = 0; i < n; ++i)
+                for (size_t k = 0; k < i; ++k)
+                {
+                    const T factor = m[(i * ld) + k];
+                    for (size_t j = 0; j < nrhs; ++j)
+                        xs[(i * ldx) + j] -= factor * xs[(k * ldx) + j];
+                }
+            for (size_t i = n; i-- > 0;)
+            {
+                for (size_t k = i + 1; k < n; ++k)
+                {
+                    const T factor = m[(i * ld) + k];
+                    for (size_t j = 0; j < nrhs; ++j)
+                        xs[(i * ldx) + j] -= factor * xs[(k * ldx) + j];
+                }
+                const T pivot = m[(i * ld) + i];
+                for (size_t j = 0; j < nrhs; ++j)
+                    xs[(i * ldx) + j] /= pivot;
+            }
+
+            if constexpr (std::is_same<Layout, RowMajor>::value)
+                return x;
+            else
+                return x.template toLayout<Layout>();
+        }
+
+        /**
+         * @brief Turns the factors into those of A + U * V^T.
+         *
+         * Applies Bennett's algorithm once per column of U and V, O(k n^2)
+         * instead of the O(n^3) of factoring again. It can't pivot, so when a
+         * pivot cancels or a multiplier grows too large the matrix is rebuilt
+         * from the factors and factored with pivoting. A downdate is an update
+         * with -U.
+         *
+         * @tparam Layout Layout of U and V.
+         * @param u n x k matrix.
+         * @param v n x k matrix.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        template<typename Layout>
+        void update(const Tensor<T, Layout>& u, const Tensor<T, Layout>& v)
+        {
+            const size_t n = lu.rows;
+            if(u.rowCount() != n || v.rowCount() != n || u.colCount() != v.colCount())
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            Tensor<T, RowMajor> updated = lu;
+            std::vector<T> x(n), y(n);
+            for (size_t r = 0; r < u.colCount(); ++r)
+            {
+                // P * (A + u * v^T) = L * U + (P * u) * v^T.
+                for (size_t i = 0; i < n; ++i)
+                {
+                    x[i] = u(perm[i], r);
+                    y[i] = v(i, r);
+                }
+                if (!rankOne(updated, x, y))
+                {
+                    Tensor<T, RowMajor> lower(n, n), upper(n, n);
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        lower.values[lower.index(i, i)] = T{1};
+                        for (size_t j = 0; j < n; ++j)
+                            (j < i ? lower.values[lower.index(i, j)] : upper.values[upper.index(i, j)]) = lu.values[lu.index(i, j)];
+                    }
+                    const Tensor<T, RowMajor> permuted = lower * upper;
+                    Tensor<T, RowMajor> a(n, n);
+                    for (size_t i = 0; i < n; ++i)
+                        for (size_t j = 0; j < n; ++j)
+                            a.values[a.index(perm[i], j)] = permuted.values[permuted.index(i, j)];
+                    *this = LU(a + (u.template toLayout<RowMajor>() * v.template toLayout<RowMajor>().transpose()));
+                    return;
+                }
+            }
+            updated.markWritten();
+            lu = std::move(updated);
+            // rankOne() fails on a zero pivot, so the updated factors are regular.
+            singular = false;
+        }
+    };
+
+    /**
+     * @brief Cholesky factorization of a symmetric positive definite matrix, A = R^T * R.
+     *
+     * The upper factor R = L^T is kept in row-major storage, so factoring,
+     * solving and the rank-one updates all stream along rows. Only the
+     * upper triangle of A is read.
+     *
+     * @tparam T Floating point type.
+     */
+    template<typename T>
+    class Cholesky
+    {
+        static_assert(std::is_floating_point<T>::value, "Cholesky requires a floating point type");
+
+    private:
+        Tensor<T, RowMajor> r;         ///< Upper triangular factor, zero below the diagonal.
+
+        /**
+         * @brief Turns the factor in f into that of R^T * R + sign * x * x^T, sign being 1 or -1.
+         *
+         * @return false if the result isn't positive definite; f is then garbage.
+         */
+        static bool rankOne(Tensor<T, RowMajor>& f, std::vector<T>& x, T sign)
+        {
+            const size_t n = f.rows;
+            const size_t ld = f.ld;
+            T* m = f.values.data();
+            for (size_t k = 0; k < n; ++k)
+            {
+                T* rowK = m + (k * ld);
+                const T diagonal = rowK[k];
+                const T squared = sign > T{0} ? (diagonal * diagonal) + (x[k] * x[k])
+                                              : (diagonal - x[k]) * (diagonal + x[k]);
+                if (!(squared > T{0}))
+                    return false;
+                const T updated = std::sqrt(squared);
+                const T c = updated / diagonal;
+                const T s = x[k] / diagonal;
+                rowK[k] = updated;
+                for (size_t i = k + 1; i < n; ++i)
+                {
+                    rowK[i] = (rowK[i] + (sign * s * x[i])) / c;
+                    x[i] = (c * x[i]) - (s * rowK[i]);
+                }
+            }
+            return true;
+        }
+
+        /// @brief Applies rankOne() for each column of x, leaving the factor unchanged if one fails.
+        template<typename Layout>
+        void rankK(const Tensor<T, Layout>& x, T sign)
+        {
+            const size_t n = r.rows;
+            if(x.rowCount() != n)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            Tensor<T, RowMajor> updated = r;
+            std::vector<T> column(n);
+            for (size_t c = 0; c < x.colCount(); ++c)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    column[i] = x(i, c);
+                if (!rankOne(updated, column, sign))
+                    TENSOR_THROW(std::runtime_error, "Matrix is not positive definite");
+            }
+            updated.markWritten();
+            r = std::move(updated);
+        }
+
+    public:
+        /**
+         * @brief Factors a symmetric positive definite matrix.
+         *
+         * @tparam Layout Layout of the input; it is copied to row-major storage.
+         * @param a Matrix to factor; only its upper triangle is read.
+         * @throws std::runtime_error if the matrix is not square or not positive definite.
+         */
+        template<typename Layout>
+        explicit Cholesky(const Tensor<T, Layout>& a)
+            : r(a.template toLayout<RowMajor>())
+        {
+            if(a.rowCount() != a.colCount())
+                TENSOR_THROW(std::runtime_error, "Matrix is not square");
+
+            const size_t n = r.rows;
+            const size_t ld = r.ld;
+            T* m = r.values.data();
+            for (size_t k = 0; k < n; ++k)
+            {
+                T* rowK = m + (k * ld);
+                std::fill(rowK, rowK + k, T{0});
+                if (!(rowK[k] > T{0}))
+                    TENSOR_THROW(std::runtime_error, "Matrix is not positive definite");
+                const T pivot = std::sqrt(rowK[k]);
+                rowK[k] = pivot;
+                for (size_t j = k + 1; j < n; ++j)
+                    rowK[j] /= pivot;
+
+                for (size_t i = k + 1; i < n; ++i)
+                {
+                    T* row = m + (i * ld);
+                    const T factor = rowK[i];
+                    for (size_t j = i; j < n; ++j)
+                        row[j] -= factor * rowK[j];
+                }
+            }
+            r.markWritten();
+        }
+
+        /**
+         * @brief Returns the determinant of the factored matrix.
+         *
+         * @return det(A).
+         */
+        T determinant() const
+        {
+            T det = T{1};
+            for (size_t i = 0; i < r.rows; ++i)
+                det *= r.values[r.index(i, i)];
+            return det * det;
+        }
+
+        /**
+         * @brief Solves A * X = B.
+         *
+         * @tparam Layout Layout of the right-hand side and result.
+         * @param b Right-hand side with as many rows as A.
+         * @return X.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        template<typename Layout>
+        Tensor<T, Layout> solve(const Tensor<T, Layout>& b) const
+        {
+            if(b.rowCount() != r.rows)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            const size_t n = r.rows;
+            const size_t nrhs = b.colCount();
+            const size_t ld = r.ld;
+            const T* m = r.values.data();
+
+            Tensor<T, RowMajor> x(n, nrhs);
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < nrhs; ++j)
+                    x.values[x.index(i, j)] = b(i, j);
+
+            T* xs = x.values.data();
+            const size_t ldx = x.ld;
+            // R^T * Y = B, eliminating by rows of R.
+            for (size_t k = 0; k < n; ++k)
+            {
+                const T pivot = m[(k * ld) + k];
+                for (size_t j = 0; j < nrhs; ++j)
+                    xs[(k * ldx) + j] /= pivot;
+                for (size_t i = k + 1; i < n; ++i)
+                {
+                    const T factor = m[(k * ld) + i];
+                    for (size_t j = 0; j < nrhs; ++j)
+                        xs[(i * ldx) + j] -= factor * xs[(k * ldx) + j];
+                }
+            }
+            for (size_t i = n; i-- > 0;)
+            {
+                for (size_t k = i + 1; k < n; ++k)
+                {
+                    const T factor = m[(i * ld) + k];
+                    for (size_t j = 0; j < nrhs; ++j)
+                        xs[(i * ldx) + j] -= factor * xs[(k * ldx) + j];
+                }
+                const T pivot = m[(i * ld) + i];
+                for (size_t j = 0; j < nrhs; ++j)
+                    xs[(i * ldx) + j] /= pivot;
+            }
+
+            if constexpr (std::is_same<Layout, RowMajor>::value)
+                return x;
+            else
+                return x.template toLayout<Layout>();
+        }
+
+        /**
+         * @brief Turns the factor into that of A + X * X^T, O(k n^2).
+         *
+         * Adding observations x to a normal matrix A = M^T * M is this with
+         * X = x^T, which keeps streaming least squares at O(n^2) per row.
+         *
+         * @tparam Layout Layout of X.
+         * @param x n x k matrix.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        template<typename Layout>
+        void update(const Tensor<T, Layout>& x)
+        {
+            rankK(x, T{1});
+        }
+
+        /**
+         * @brief Turns the factor into that of A - X * X^T, O(k n^2).
+         *
+         * @tparam Layout Layout of X.
+         * @param x n x k matrix.
+         * @throws std::runtime_error if dimensions mismatch or A - X * X^T is not
+         *         positive definite; the factor is then unchanged.
+         */
+        template<typename Layout>
+        void downdate(const Tensor<T, Layout>& x)
+        {
+            rankK(x, T{-1});
+        }
+    };
+
+    /**
+     * @brief QR factorization A = Q * R of an m x n matrix, kept with an explicit Q.
+     *
+     * Factored with Householder reflections. Q^T rather than Q is stored, so
+     * the Givens rotations of update() combine rows, which are contiguous
+     * in row-major storage. The explicit Q costs O(m^2) memory and buys
+     * O(m^2 + m n) rank-one updates in place of O(m n^2) refactoring.
+     *
+     * @tparam T Floating point type.
+     */
+    template<typename T>
+    class QR
+    {
+        static_assert(std::is_floating_point<T>::value, "QR requires a floating point type");
+
+    private:
+        Tensor<T, RowMajor> qt;        ///< Q^T, m x m orthogonal.
+        Tensor<T, RowMajor> r;         ///< m x n, zero below the diagonal.
+
+        /// @brief Rotates rows x and y by [c s; -s c].
+        static void rotate(T* x, T* y, size_t length, T c, T s)
+        {
+            for (size_t j = 0; j < length; ++j)
+            {
+                const T first = x[j];
+                x[j] = (c * first) + (s * y[j]);
+                y[j] = (c * y[j]) - (s * first);
+            }
+        }
+
+        /**
+         * @brief Rotates rows k and k + 1 of Q^T, and of R from column from on, so that (a, b) becomes (rho, 0).
+         *
+         * @return rho.
+         */
+        T givens(size_t k, size_t from, T a, T b)
+        {
+            const T rho = std::hypot(a, b);
+            const T c = a / rho;
+            const T s = b / rho;
+            if (from < r.cols)
+                rotate(r.values.data() + (k * r.ld) + from, r.values.data() + ((k + 1) * r.ld) + from, r.cols - from, c, s);
+            rotate(qt.values.data() + (k * qt.ld), qt.values.data() + ((k + 1) * qt.ld), qt.cols, c, s);
+            return rho;
+        }
+
+    public:
+        /**
+         * @brief Factors an m x n matrix.
+         *
+         * @tparam Layout Layout of the input; it is copied to row-major storage.
+         * @param a Matrix to factor.
+         */
+        template<typename Layout>
+        explicit QR(const Tensor<T, Layout>& a)
+            : qt(Tensor<T, RowMajor>::eye(a.rowCount())), r(a.template toLayout<RowMajor>())
+        {
+            const size_t m = r.rows;
+            const size_t n = r.cols;
+            T* rm = r.values.data();
+            std::vector<T> v(m), w(std::max(m, n));
+            for (size_t k = 0; k + 1 < m && k < n; ++k)
+            {
+                T norm = T{0};
+                for (size_t i = k; i < m; ++i)
+                    norm += rm[(i * r.ld) + k] * rm[(i * r.ld) + k];
+                norm = std::sqrt(norm);
+                if (norm == T{0})
+                    continue;
+
+                const T alpha = rm[(k * r.ld) + k] > T{0} ? -norm : norm;
+                T length = T{0};
+                for (size_t i = k; i < m; ++i)
+                {
+                    v[i] = rm[(i * r.ld) + k] - (i == k ? alpha : T{0});
+                    length += v[i] * v[i];
+                }
+                const T scale = T{2} / length;
+
+                // (I - scale * v * v^T) applied to rows k.. of a matrix, one row at a time.
+                auto reflect = [&](Tensor<T, RowMajor>& target, size_t from)
+                {
+                    T* base = target.values.data();
+                    const size_t to = target.cols;
+                    std::fill(w.begin() + from, w.begin() + to, T{0});
+                    for (size_t i = k; i < m; ++i)
+                    {
+                        const T* row = base + (i * target.ld);
+                        for (size_t j = from; j < to; ++j)
+                            w[j] += v[i] * row[j];
+                    }
+                    for (size_t i = k; i < m; ++i)
+                    {
+                        T* row = base + (i * target.ld);
+                        const T factor = scale * v[i];
+                        for (size_t j = from; j < to; ++j)
+                            row[j] -= factor * w[j];
+                    }
+                };
+                reflect(r, k + 1);
+                reflect(qt, 0);
+                rm[(k * r.ld) + k] = alpha;
+                for (size_t i = k + 1; i < m; ++i)
+                    rm[(i * r.ld) + k] = T{0};
+            }
+            r.markWritten();
+            qt.markWritten();
+        }
+
+        /**
+         * @brief Reports whether R has a zero on its diagonal.
+         *
+         * @return true if A has lower rank than min(m, n).
+         */
+        bool isSingular() const
+        {
+            for (size_t i = 0; i < std::min(r.rows, r.cols); ++i)
+                if (r.values[r.index(i, i)] == T{0})
+                    return true;
+            return false;
+        }
+
+        /**
+         * @brief Solves A * X = B in the least squares sense.
+         *
+         * @tparam Layout Layout of the right-hand side and result.
+         * @param b Right-hand side with as many rows as A.
+         * @return n x nrhs minimizer of ||A * X - B||.
+         * @throws std::runtime_error if dimensions mismatch, A has fewer rows than
+         *         columns or A is rank deficient.
+         */
+        template<typename Layout>
+        Tensor<T, Layout> solve(const Tensor<T, Layout>& b) const
+        {
+            if(b.rowCount() != r.rows || r.rows < r.cols)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+            if (isSingular())
+                TENSOR_THROW(std::runtime_error, "Matrix is singular");
+
+            const size_t n = r.cols;
+            const size_t nrhs = b.colCount();
+            const size_t ld = r.ld;
+            const T* m = r.values.data();
+
+            Tensor<T, RowMajor> x = qt * b.template toLayout<RowMajor>();
+            T* xs = x.values.data();
+            const size_t ldx = x.ld;
+            for (size_t i = n; i-- > 0;)
+            {
+                for (size_t k = i + 1; k < n; ++k)
+                {
+                    const T factor = m[(i * ld) + k];
+                    for (size_t j = 0; j < nrhs; ++j)
+                        xs[(i * ldx) + j] -= factor * xs[(k * ldx) + j];
+                }
+                const T pivot = m[(i * ld) + i];
+                for (size_t j = 0; j < nrhs; ++j)
+                    xs[(i * ldx) + j] /= pivot;
+            }
+
+            Tensor<T, Layout> result(n, nrhs);
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < nrhs; ++j)
+                    result(i, j) = xs[(i * ldx) + j];
+            return result;
+        }
+
+        /**
+         * @brief Turns the factors into those of A + U * V^T, O(k (m^2 + m n)).
+         *
+         * Per column u, v of U, V: Givens rotations fold w = Q^T * u into
+         * its first element, which makes R upper Hessenberg, the rank-one
+         * term lands on R's first row, and a second sweep restores the
+         * triangle. A downdate is an update with -U.
+         *
+         * @tparam Layout Layout of U and V.
+         * @param u m x k matrix.
+         * @param v n x k matrix.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        template<typename Layout>
+        void update(const Tensor<T, Layout>& u, const Tensor<T, Layout>& v)
+        {
+            const size_t m = r.rows;
+            const size_t n = r.cols;
+            if(u.rowCount() != m || v.rowCount() != n || u.colCount() != v.colCount())
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            std::vector<T> column(m), w(m);
+            for (size_t c = 0; c < u.colCount(); ++c)
+            {
+                for (size_t j = 0; j < m; ++j)
+                    column[j] = u(j, c);
+                for (size_t i = 0; i < m; ++i)
+                {
+                    const T* row = qt.values.data() + (i * qt.ld);
+                    T sum = T{0};
+                    for (size_t j = 0; j < m; ++j)
+                        sum += row[j] * column[j];
+                    w[i] = sum;
+                }
+
+                for (size_t k = m - 1; k > 0; --k)
+                    if (w[k] != T{0})
+                    {
+                        w[k - 1] = givens(k - 1, k - 1, w[k - 1], w[k]);
+                        w[k] = T{0};
+                    }
+
+                T* first = r.values.data();
+                for (size_t j = 0; j < n; ++j)
+                    first[j] += w[0] * v(j, c);
+
+                for (size_t k = 0; k + 1 < m && k < n; ++k)
+                {
+                    T& below = r.values[r.index(k + 1, k)];
+                    if (below != T{0})
+                    {
+                        givens(k, k, r.values[r.index(k, k)], below);
+                        below = T{0};
+                    }
+                }
+            }
+            r.markWritten();
+            qt.markWritten();
+        }
+    };
+
+    /**
+     * @brief Turns A^-1 into (A + U * V^T)^-1 by the Sherman-Morrison-Woodbury formula.
+     *
+     * (A + U V^T)^-1 = A^-1 - A^-1 U (I + V^T A^-1 U)^-1 V^T A^-1, which costs
+     * O(k n^2) plus a k x k solve rather than an O(n^3) inversion. Rounding
+     * errors accumulate over repeated updates; re-invert now and then.
+     *
+     * @tparam T Floating point type.
+     * @tparam Layout Storage layout.
+     * @param inverse n x n inverse of A, replaced by the updated inverse.
+     * @param u n x k matrix.
+     * @param v n x k matrix.
+     * @throws std::runtime_error if dimensions mismatch or A + U * V^T is singular.
+     */
+    template<typename T, typename Layout>
+    void updateInverse(Tensor<T, Layout>& inverse, const Tensor<T, Layout>& u, const Tensor<T, Layout>& v)
+    {
+        if(inverse.rowCount() != inverse.colCount())
+            TENSOR_THROW(std::runtime_error, "Matrix is not square");
+        if(u.rowCount() != inverse.rowCount() || v.rowCount() != inverse.rowCount() || u.colCount() != v.colCount())
+            TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+        const Tensor<T, Layout> left = inverse * u;
+        const Tensor<T, Layout> right = v.transpose() * inverse;
+        const LU<T> capacitance(Tensor<T, Layout>::eye(u.colCount()) + (right * u));
+        if (capacitance.isSingular())
+            TENSOR_THROW(std::runtime_error, "Matrix is singular");
+        inverse = inverse - (left * capacitance.solve(right));
+    }
+}
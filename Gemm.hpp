@@ -0,0 +1,861 @@
+/**
+ * @file Gemm.hpp
+ * @brief Matrix product kernels on raw row-major buffers used by Tensor.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "Jit.hpp"
+#include "Parallel.hpp"
+#include "Semiring.hpp"
+#include "Simd.hpp"
+
+namespace Tensor
+{
+    /**
+     * @brief Kernels a matrix product can run on.
+     *
+     * Used to force a kernel through config::gemmPath and to report the one
+     * taken through config::gemmObserver.
+     */
+    enum class GemmPath
+    {
+        Auto,           ///< Let the cost model choose (config::gemmPath only).
+        Unpacked,       ///< i-k-j loops over the operands as stored.
+        Jit,            ///< Kernel generated for the exact shape (Jit.hpp).
+        Gemv,           ///< Matrix-vector product, one dot product per row of C.
+        SparseA,        ///< i-k-j loops skipping the zero elements of A.
+        Packed,         ///< Packed micro-kernel, row blocks shared out.
+        ColumnParallel, ///< Packed micro-kernel, column blocks shared out.
+        SplitK          ///< Packed micro-kernel on K slices whose partials are added.
+    };
+
+    /**
+     * @brief Machine parameters of the product cost model, in multiply-adds or elements per ns.
+     *
+     * The defaults are conservative figures for a current x86-64 core;
+     * tuneGemmCostModel() measures them instead.
+     */
+    struct GemmCostModel
+    {
+        double unpackedRate = 4.0;  ///< Multiply-adds per ns of the i-k-j loops, B in cache.
+        double streamRate = 1.0;    ///< Multiply-adds per ns of the i-k-j loops, B streamed from memory.
+        size_t cacheBytes = size_t{1} << 20; ///< Largest B the i-k-j loops keep in cache.
+        double jitRate = 8.0;       ///< Multiply-adds per ns of a generated kernel.
+        double gemvRate = 4.0;      ///< Multiply-adds per ns of the matrix-vector kernel.
+        double packedRate = 16.0;   ///< Multiply-adds per ns of the packed kernel on one thread.
+        double packRate = 1.0;      ///< Elements per ns copied into packed panels.
+        double scanRate = 2.0;      ///< Elements of A per ns tested by the zero-skipping loops.
+        double packedCallNs = 1000; ///< Fixed cost of a packed product (buffers, blocking loops).
+        double parallelNs = 5000;   ///< Fixed cost of spreading a product over the pool.
+    };
+
+    /**
+     * @brief The kernel one product ran on, with the cost model's view of it.
+     */
+    struct GemmDecision
+    {
+        size_t M, N, K;     ///< Shape: (M x K) * (K x N).
+        GemmPath path;      ///< Kernel taken.
+        double estimatedNs; ///< Modelled cost of that kernel.
+        double densityA;    ///< Sampled fraction of nonzero elements of A, 1 when not sampled.
+    };
+
+    namespace config
+    {
+        /**
+         * @brief Multiply-add count (M * N * K) below which the packed and zero-skipping kernels aren't considered.
+         *
+         * Packing costs O(MK + KN) extra traffic, which small products don't
+         * recover; below this the cost model picks among the unpacked,
+         * generated and matrix-vector kernels.
+         */
+        inline size_t packedGemmThreshold = size_t{32} * 32 * 32;
+
+        /**
+         * @brief Multiply-add count above which products are spread over the thread pool.
+         */
+        inline size_t parallelGemmThreshold = size_t{128} * 128 * 128;
+
+        /**
+         * @brief K extent of one slice when config::deterministic splits a product along K.
+         */
+        inline size_t deterministicKSlice = 1024;
+
+        /// @brief Cost model parameters products are dispatched by; see tuneGemmCostModel().
+        inline GemmCostModel gemmCost;
+
+        /**
+         * @brief Kernel every product is forced onto, or GemmPath::Auto to let the cost model choose.
+         *
+         * A forced kernel that can't run a product (GEMV with N > 1, a
+         * generated kernel for a large shape, a (+, *)-only kernel under
+         * another semiring) falls back to the cost model's choice.
+         */
+        inline GemmPath gemmPath = GemmPath::Auto;
+
+        /**
+         * @brief Whether large (+, *) products sample A for zeros and may skip them.
+         *
+         * The zero-skipping loops don't form 0 * B(k, j), so an infinity or
+         * NaN in B that only ever meets zeros of A doesn't reach C. Off by
+         * default for that reason, like config::structuredProducts.
+         */
+        inline bool sparseGemm = false;
+
+        /// @brief Elements of A sampled to estimate its density.
+        inline size_t densitySamples = 128;
+
+        /**
+         * @brief Called after every product with the kernel it ran on; null for none.
+         *
+         * Runs on the calling thread, so it must be cheap and must not
+         * multiply. Blocked tensors multiply tile by tile on their own kernel,
+         * which isn't dispatched here and isn't reported; nor are products
+         * Tensor short-cuts by operand structure (config::structuredProducts).
+         */
+        inline void (*gemmObserver)(const GemmDecision& decision) = nullptr;
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief C += A * B on raw row-major buffers with leading dimensions.
+         *
+         * Uses i-k-j order so the innermost loop streams contiguous rows of B and C.
+         * Like every kernel below, + and * are those of the semiring S.
+         */
+        template<typename T, typename S = PlusTimes<T>>
+        void gemmRowMajor(size_t M, size_t N, size_t K,
+                          const T* a, size_t lda, const T* b, size_t ldb, T* c, size_t ldc)
+        {
+            for (size_t i = 0; i < M; ++i)
+            {
+                T* cRow = c + (i * ldc);
+                for (size_t k = 0; k < K; ++k)
+                {
+                    const T aik = a[(i * lda) + k];
+                    const T* bRow = b + (k * ldb);
+                    for (size_t j = 0; j < N; ++j)
+                        cRow[j] = S::add(cRow[j], S::mul(aik, bRow[j]));
+                }
+            }
+        }
+
+        /**
+         * @brief Read-only matrix operand whose element (i, j) is data[i * rowStride + j * colStride].
+         *
+         * Lets the packed kernels read a transposed operand in place: a
+         * row-major buffer with leading dimension ld is {data, ld, 1}, its
+         * transpose {data, 1, ld}.
+         */
+        template<typename T>
+        struct Strided
+        {
+            const T* data;
+            size_t rowStride, colStride;
+
+            const T* at(size_t i, size_t j) const { return data + (i * rowStride) + (j * colStride); }
+            Strided from(size_t i, size_t j) const { return {at(i, j), rowStride, colStride}; }
+        };
+
+        /**
+         * @brief Cache blocking of the packed kernel for element type T.
+         *
+         * The micro-tile MR x NR stays in registers (NR is two vector registers
+         * wide when T has vector ops), a KC x NR panel of B stays in L1, an
+         * MC x KC block of A in L2 and a KC x NC slice of B in L3.
+         */
+        template<typename T>
+        struct GemmBlocking
+        {
+            static constexpr bool vectorized = simd::VecOps<T>::available && simd::VecOps<T>::hasMul;
+            static constexpr size_t MR = vectorized ? 6 : 4;
+            static constexpr size_t NR = vectorized ? 2 * simd::widthOf<T>() : 4;
+            static constexpr size_t KC = 256;
+            static constexpr size_t MC = MR * 16;
+            static constexpr size_t NC = NR * 128;
+        };
+
+        /**
+         * @brief Packs rows [0, mc) x cols [0, kc) of A into MR-row slivers, k-major.
+         *
+         * Sliver s holds rows s*MR.. as ap[s * kc * MR + k * MR + i]; rows past
+         * mc are zero so the micro-kernel never needs a row edge case.
+         */
+        template<typename T>
+        void packA(size_t mc, size_t kc, Strided<T> a, T* ap)
+        {
+            constexpr size_t MR = GemmBlocking<T>::MR;
+            for (size_t ir = 0; ir < mc; ir += MR)
+            {
+                const size_t mr = std::min(MR, mc - ir);
+                for (size_t k = 0; k < kc; ++k)
+                {
+                    for (size_t i = 0; i < mr; ++i)
+                        ap[(k * MR) + i] = *a.at(ir + i, k);
+                    for (size_t i = mr; i < MR; ++i)
+                        ap[(k * MR) + i] = T{};
+                }
+                ap += kc * MR;
+            }
+        }
+
+        /**
+         * @brief Packs a kc x nc block of B into NR-column panels, k-major.
+         *
+         * Element (k, j) is read from b[k * rowStride + j * colStride], so
+         * row- and column-major sources pack alike. Panel p holds columns
+         * p*NR.. as bp[p * kc * NR + k * NR + j]; columns past nc are zero.
+         */
+        template<typename T>
+        void packB(size_t kc, size_t nc, const T* b, size_t rowStride, size_t colStride, T* bp)
+        {
+            constexpr size_t NR = GemmBlocking<T>::NR;
+            for (size_t jr = 0; jr < nc; jr += NR)
+            {
+                const size_t nr = std::min(NR, nc - jr);
+                for (size_t k = 0; k < kc; ++k)
+                {
+                    for (size_t j = 0; j < nr; ++j)
+                        bp[(k * NR) + j] = b[(k * rowStride) + ((jr + j) * colStride)];
+                    for (size_t j = nr; j < NR; ++j)
+                        bp[(k * NR) + j] = T{};
+                }
+                bp += kc * NR;
+            }
+        }
+
+        /**
+         * @brief C[0:mr, 0:nr] += A sliver * B panel over kc steps.
+         *
+         * The full MR x NR tile is accumulated in registers and only the valid
+         * mr x nr corner is added to C. The zero padding of the packed operands
+         * only reaches the discarded part of the tile, whatever the semiring.
+         */
+        template<typename T, typename S = PlusTimes<T>>
+        void microKernel(size_t kc, const T* ap, const T* bp, T* c, size_t ldc, size_t mr, size_t nr)
+        {
+            constexpr size_t MR = GemmBlocking<T>::MR;
+            constexpr size_t NR = GemmBlocking<T>::NR;
+            alignas(64) T tile[MR][NR];
+
+            if constexpr (GemmBlocking<T>::vectorized && S::vectorized)
+            {
+                using V = simd::VecOps<T>;
+                constexpr size_t NV = NR / V::width;
+                typename V::reg acc[MR][NV];
+                for (size_t i = 0; i < MR; ++i)
+                    for (size_t v = 0; v < NV; ++v)
+                        acc[i][v] = V::set1(S::zero());
+
+                for (size_t k = 0; k < kc; ++k)
+                {
+                    typename V::reg bv[NV];
+                    for (size_t v = 0; v < NV; ++v)
+                        bv[v] = V::loadu(bp + (k * NR) + (v * V::width));
+                    for (size_t i = 0; i < MR; ++i)
+                    {
+                        const typename V::reg av = V::set1(ap[(k * MR) + i]);
+                        for (size_t v = 0; v < NV; ++v)
+                            acc[i][v] = S::template vadd<V>(acc[i][v], S::template vmul<V>(av, bv[v]));
+                    }
+                }
+
+                // Full tiles go straight from registers to C; with a short K (tall-skinny
+                // products) a round trip through the tile buffer would cost as much as the FMAs.
+                if (mr == MR && nr == NR)
+                {
+                    for (size_t i = 0; i < MR; ++i)
+                        for (size_t v = 0; v < NV; ++v)
+                        {
+                            T* out = c + (i * ldc) + (v * V::width);
+                            V::storeu(out, S::template vadd<V>(V::loadu(out), acc[i][v]));
+                        }
+                    return;
+                }
+                for (size_t i = 0; i < MR; ++i)
+                    for (size_t v = 0; v < NV; ++v)
+                        V::store(&tile[i][v * V::width], acc[i][v]);
+            }
+            else
+            {
+                for (size_t i = 0; i < MR; ++i)
+                    for (size_t j = 0; j < NR; ++j)
+                        tile[i][j] = S::zero();
+                for (size_t k = 0; k < kc; ++k)
+                    for (size_t i = 0; i < MR; ++i)
+                    {
+                        const T aik = ap[(k * MR) + i];
+                        for (size_t j = 0; j < NR; ++j)
+                            tile[i][j] = S::add(tile[i][j], S::mul(aik, bp[(k * NR) + j]));
+                    }
+            }
+
+            for (size_t i = 0; i < mr; ++i)
+                for (size_t j = 0; j < nr; ++j)
+                    c[(i * ldc) + j] = S::add(c[(i * ldc) + j], tile[i][j]);
+        }
+
+        /**
+         * @brief Number of elements of B packed as a whole by packWhole().
+         */
+        template<typename T>
+        size_t packedSize(size_t K, size_t N)
+        {
+            constexpr size_t NR = GemmBlocking<T>::NR;
+            return K * (((N + NR - 1) / NR) * NR);
+        }
+
+        /**
+         * @brief Packs all of B (K x N) once, in the order gemmPacked() consumes it.
+         *
+         * For each KC block of rows, every NR panel across all N columns follows
+         * in turn, so the slice used for a (pc, jc) step is contiguous.
+         */
+        template<typename T>
+        void packWhole(size_t K, size_t N, const T* b, size_t rowStride, size_t colStride, T* bp)
+        {
+            constexpr size_t KC = GemmBlocking<T>::KC;
+            const size_t paddedN = packedSize<T>(1, N);
+            for (size_t pc = 0; pc < K; pc += KC)
+            {
+                const size_t kc = std::min(KC, K - pc);
+                packB(kc, N, b + (pc * rowStride), rowStride, colStride, bp + (pc * paddedN));
+            }
+        }
+
+        /**
+         * @brief Blocked C += A * B where B comes pre-packed.
+         *
+         * Above config::parallelGemmThreshold the MC row blocks of each step
+         * are shared out over the thread pool. Every element of C is still
+         * accumulated by one thread in ascending K order, so the result doesn't
+         * depend on the thread count.
+         *
+         * @param panelsOf Callable (pc, jc, kc, nc) returning the packed panels of
+         *        B rows [pc, pc + kc) and columns [jc, jc + nc), laid out as packB() does.
+         */
+        template<typename T, typename S = PlusTimes<T>, typename PanelSource>
+        void gemmPacked(size_t M, size_t N, size_t K, Strided<T> a,
+                        PanelSource&& panelsOf, T* c, size_t ldc)
+        {
+            using B = GemmBlocking<T>;
+            const size_t rowBlocks = (M + B::MC - 1) / B::MC;
+            const bool parallel = M * N * K >= config::parallelGemmThreshold;
+
+            for (size_t jc = 0; jc < N; jc += B::NC)
+            {
+                const size_t nc = std::min(B::NC, N - jc);
+                for (size_t pc = 0; pc < K; pc += B::KC)
+                {
+                    const size_t kc = std::min(B::KC, K - pc);
+                    const T* bp = panelsOf(pc, jc, kc, nc);
+                    auto rowBlockRange = [&](size_t firstBlock, size_t lastBlock)
+                    {
+                        thread_local std::vector<T> aPack;
+                        aPack.resize(B::MC * B::KC);
+                        for (size_t ic = firstBlock * B::MC; ic < std::min(M, lastBlock * B::MC); ic += B::MC)
+                        {
+                            const size_t mc = std::min(B::MC, M - ic);
+                            packA(mc, kc, a.from(ic, pc), aPack.data());
+                            for (size_t jr = 0; jr < nc; jr += B::NR)
+                            {
+                                const T* panel = bp + ((jr / B::NR) * kc * B::NR);
+                                for (size_t ir = 0; ir < mc; ir += B::MR)
+                                    microKernel<T, S>(kc, aPack.data() + ((ir / B::MR) * kc * B::MR), panel,
+                                                      c + ((ic + ir) * ldc) + jc + jr, ldc,
+                                                      std::min(B::MR, mc - ir), std::min(B::NR, nc - jr));
+                            }
+                        }
+                    };
+                    if (parallel)
+                        parallelFor(rowBlocks, 1, rowBlockRange);
+                    else
+                        rowBlockRange(0, rowBlocks);
+                }
+            }
+        }
+
+        /**
+         * @brief C += A * B through the packed kernel, packing B slice by slice.
+         */
+        template<typename T, typename S = PlusTimes<T>>
+        void gemmPackB(size_t M, size_t N, size_t K, Strided<T> a, Strided<T> b, T* c, size_t ldc)
+        {
+            thread_local std::vector<T> bPack;
+            bPack.resize(GemmBlocking<T>::KC * packedSize<T>(1, std::min(N, GemmBlocking<T>::NC)));
+            gemmPacked<T, S>(M, N, K, a, [&](size_t pc, size_t jc, size_t kc, size_t nc)
+            {
+                packB(kc, nc, b.at(pc, jc), b.rowStride, b.colStride, bPack.data());
+                return static_cast<const T*>(bPack.data());
+            }, c, ldc);
+        }
+
+        /**
+         * @brief Whether a product should share out its NC column blocks instead of its row blocks.
+         *
+         * Short-wide products (say 64 x 64 times 64 x 10^6) have a single MC
+         * row block, so the row-parallel kernel would run on one thread, while
+         * their columns split into many independent blocks. Every element of C
+         * is still accumulated by one thread in K order, so the choice doesn't
+         * change the result.
+         */
+        template<typename T>
+        bool columnParallel(size_t M, size_t N, size_t K)
+        {
+            using B = GemmBlocking<T>;
+            const size_t threads = threadCount();
+            return M * N * K >= config::parallelGemmThreshold && threads > 1
+                && (M + B::MC - 1) / B::MC < threads && (N + B::NC - 1) / B::NC >= 2;
+        }
+
+        /**
+         * @brief C += A * B with the NC column blocks of B and C spread over the thread pool.
+         */
+        template<typename T, typename S = PlusTimes<T>>
+        void gemmColumnBlocks(size_t M, size_t N, size_t K, Strided<T> a, Strided<T> b, T* c, size_t ldc)
+        {
+            constexpr size_t NC = GemmBlocking<T>::NC;
+            parallelFor((N + NC - 1) / NC, 1, [&](size_t first, size_t last)
+            {
+                for (size_t block = first; block < last; ++block)
+                {
+                    const size_t jc = block * NC;
+                    gemmPackB<T, S>(M, std::min(NC, N - jc), K, a, b.from(0, jc), c + jc, ldc);
+                }
+            });
+        }
+
+        /**
+         * @brief Number of K slices for a product, or 1 to keep K whole.
+         *
+         * Splitting K pays off when C has too few row blocks to keep the pool
+         * busy. In config::deterministic mode the choice depends on the shape
+         * alone; otherwise K is cut into one slice per thread.
+         */
+        template<typename T>
+        size_t kSlices(size_t M, size_t N, size_t K)
+        {
+            using B = GemmBlocking<T>;
+            if (M * N * K < config::parallelGemmThreshold)
+                return 1;
+            const size_t rowBlocks = (M + B::MC - 1) / B::MC;
+            if (config::deterministic)
+            {
+                const size_t slice = std::max<size_t>(config::deterministicKSlice, 1);
+                return rowBlocks == 1 && K >= 2 * slice ? (K + slice - 1) / slice : 1;
+            }
+            const size_t threads = threadCount();
+            if (threads <= 1 || rowBlocks >= threads || K < 2 * B::KC)
+                return 1;
+            return std::min(threads, K / B::KC);
+        }
+
+        /**
+         * @brief C += A * B with K cut into slices multiplied in parallel.
+         *
+         * Slices run in waves of one per thread, each into its own M x N
+         * partial, and every wave's partials are added to C in slice order.
+         * The sum is therefore C + P0 + P1 + ... whatever the wave size, and
+         * the scratch stays at one partial per thread however long K is.
+         */
+        template<typename T, typename S = PlusTimes<T>>
+        void gemmSplitK(size_t M, size_t N, size_t K, size_t slices, Strided<T> a, Strided<T> b, T* c, size_t ldc)
+        {
+            constexpr size_t KC = GemmBlocking<T>::KC;
+            const size_t sliceK = config::deterministic
+                ? std::max<size_t>(config::deterministicKSlice, 1)
+                : (((K + slices - 1) / slices) + KC - 1) / KC * KC;
+            slices = (K + sliceK - 1) / sliceK;
+
+            const size_t wave = std::min(slices, threadCount());
+            std::vector<T> partials(wave * M * N);
+            for (size_t firstSlice = 0; firstSlice < slices; firstSlice += wave)
+            {
+                const size_t count = std::min(wave, slices - firstSlice);
+                std::fill(partials.begin(), partials.begin() + static_cast<std::ptrdiff_t>(count * M * N), S::zero());
+                parallelFor(count, 1, [&](size_t first, size_t last)
+                {
+                    for (size_t w = first; w < last; ++w)
+                    {
+                        const size_t k0 = (firstSlice + w) * sliceK;
+                        gemmPackB<T, S>(M, N, std::min(sliceK, K - k0), a.from(0, k0), b.from(k0, 0),
+                                        partials.data() + (w * M * N), N);
+                    }
+                });
+
+                for (size_t w = 0; w < count; ++w)
+                {
+                    const T* partial = partials.data() + (w * M * N);
+                    for (size_t i = 0; i < M; ++i)
+                        for (size_t j = 0; j < N; ++j)
+                            c[(i * ldc) + j] = S::add(c[(i * ldc) + j], partial[(i * N) + j]);
+                }
+            }
+        }
+
+        /**
+         * @brief C += A * B in i-k-j order over the operands as stored.
+         */
+        template<typename T, typename S = PlusTimes<T>>
+        void gemmUnpacked(size_t M, size_t N, size_t K, Strided<T> a, Strided<T> b, T* c, size_t ldc)
+        {
+            if (a.colStride == 1 && b.colStride == 1)
+            {
+                gemmRowMajor<T, S>(M, N, K, a.data, a.rowStride, b.data, b.rowStride, c, ldc);
+                return;
+            }
+            for (size_t i = 0; i < M; ++i)
+                for (size_t k = 0; k < K; ++k)
+                {
+                    const T aik = *a.at(i, k);
+                    const Strided<T> bRow = b.from(k, 0);
+                    for (size_t j = 0; j < N; ++j)
+                        c[(i * ldc) + j] = S::add(c[(i * ldc) + j], S::mul(aik, *bRow.at(0, j)));
+                }
+        }
+
+        /**
+         * @brief c(i) += A(i, :) . b for a single contiguous column b, rows of A contiguous.
+         *
+         * Packing a one-column B would fill a whole NR-wide panel, so N == 1
+         * runs as one vectorized dot product per row of A instead.
+         */
+        template<typename T>
+        void gemv(size_t M, size_t K, Strided<T> a, const T* b, T* c, size_t ldc)
+        {
+            auto rows = [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                    c[i * ldc] += simd::dot(a.at(i, 0), b, K);
+            };
+            if (M * K >= config::parallelGemmThreshold)
+                parallelFor(M, 1, rows);
+            else
+                rows(0, M);
+        }
+
+        /**
+         * @brief C += A * B in i-k-j order, skipping the rows of B met by a zero of A.
+         *
+         * Costs one test per element of A, and saves a row of N multiply-adds
+         * per zero; see config::sparseGemm for the 0 * infinity caveat.
+         */
+        template<typename T>
+        void gemmSkipZeros(size_t M, size_t N, size_t K, Strided<T> a, Strided<T> b, T* c, size_t ldc)
+        {
+            auto rows = [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    T* cRow = c + (i * ldc);
+                    for (size_t k = 0; k < K; ++k)
+                    {
+                        const T aik = *a.at(i, k);
+                        if (aik == T{})
+                            continue;
+                        const T* bRow = b.at(k, 0);
+                        if (b.colStride == 1)
+                            for (size_t j = 0; j < N; ++j)
+                                cRow[j] += aik * bRow[j];
+                        else
+                            for (size_t j = 0; j < N; ++j)
+                                cRow[j] += aik * bRow[j * b.colStride];
+                    }
+                }
+            };
+            if (M * N * K >= config::parallelGemmThreshold)
+                parallelFor(M, 1, rows);
+            else
+                rows(0, M);
+        }
+
+        /**
+         * @brief Fraction of nonzero elements among config::densitySamples elements of A.
+         *
+         * Sample s is at the fractional part of s times the golden ratio, a
+         * low-discrepancy sequence that doesn't alias with banded or block
+         * structure the way an even stride would. Deterministic for given A.
+         */
+        template<typename T>
+        double sampleDensity(size_t M, size_t K, Strided<T> a)
+        {
+            const size_t total = M * K;
+            const size_t samples = std::min(config::densitySamples, total);
+            if (samples == 0)
+                return 1.0;
+            size_t nonzero = 0;
+            for (size_t s = 0; s < samples; ++s)
+            {
+                const double position = static_cast<double>(s) * 0.6180339887498949;
+                const size_t e = std::min(total - 1, static_cast<size_t>((position - static_cast<double>(static_cast<uint64_t>(position))) * static_cast<double>(total)));
+                nonzero += *a.at(e / K, e % K) != T{};
+            }
+            return static_cast<double>(nonzero) / static_cast<double>(samples);
+        }
+
+        /**
+         * @brief Picks the kernel for C += A * B from config::gemmCost, or config::gemmPath if it can run.
+         *
+         * Each kernel able to run the product is costed as its multiply-adds
+         * over its rate, divided by the threads it would keep busy, plus:
+         *  - for the packed family, the packing traffic and fixed call cost,
+         *    and for split K the partials it adds up,
+         *  - for the zero-skipping loops, the scan of A, with the multiply-adds
+         *    scaled by the sampled density of A,
+         *  - the pool's fixed cost when the work is spread over it.
+         *
+         * Below config::packedGemmThreshold only the unpacked, generated and
+         * GEMV kernels are considered. Within the packed family the row,
+         * column or K split follows the shape rules above. In
+         * config::deterministic mode every cost is taken on one thread, so the
+         * kernel, and with it the summation order, doesn't depend on the
+         * thread count. Generated kernels are left out there as well: whether
+         * one exists depends on the products run before (config::jitMinUses,
+         * the kernel cache), not on this one.
+         *
+         * @param slices Set to the K slices to use if the choice is GemmPath::SplitK.
+         * @param kernel Set to the generated kernel if the choice is GemmPath::Jit.
+         */
+        template<typename T, typename S>
+        GemmDecision chooseGemm(size_t M, size_t N, size_t K, Strided<T> a, Strided<T> b, size_t ldc,
+                                size_t& slices, jit::Kernel<T>& kernel)
+        {
+            using B = GemmBlocking<T>;
+            constexpr bool plain = std::is_same<S, PlusTimes<T>>::value;
+            constexpr double never = std::numeric_limits<double>::infinity();
+            const GemmCostModel& model = config::gemmCost;
+            // Rates are measured on float; wider elements fill fewer lanes per vector.
+            constexpr double lanes = sizeof(T) > sizeof(float) ? static_cast<double>(sizeof(float)) / sizeof(T) : 1.0;
+            const double work = static_cast<double>(M) * static_cast<double>(N) * static_cast<double>(K) * (1.0 / lanes);
+            // Rows shorter than NR leave the i-k-j inner loop, and the packed tile, partly idle.
+            auto filled = [](size_t n, size_t tile) { return static_cast<double>(n) / static_cast<double>(((n + tile - 1) / tile) * tile); };
+            const double rowFill = filled(N, B::NR);
+            const double unpackedRate = rowFill
+                * (K * N * sizeof(T) > model.cacheBytes ? std::min(model.unpackedRate, model.streamRate) : model.unpackedRate);
+            const bool large = M * N * K >= config::packedGemmThreshold;
+            const size_t threads = config::deterministic || M * N * K < config::parallelGemmThreshold ? 1 : threadCount();
+            const bool parallel = threads > 1;
+            const GemmPath forced = config::gemmPath;
+            const bool generated = plain && !config::deterministic && a.colStride == 1 && b.colStride == 1
+                && jit::eligible<T>(M, N, K, a.rowStride, b.rowStride, ldc);
+            if (!large && !parallel && forced == GemmPath::Auto)
+            {
+                // Small products run serially with no fixed costs, so the fastest rate wins.
+                GemmPath path = GemmPath::Unpacked;
+                double rate = unpackedRate;
+                if constexpr (plain)
+                {
+                    if (N == 1 && a.colStride == 1 && b.rowStride == 1 && model.gemvRate > rate)
+                    {
+                        path = GemmPath::Gemv;
+                        rate = model.gemvRate;
+                    }
+                    if (generated && model.jitRate > rate && (kernel = jit::kernel<T>(M, N, K, a.rowStride, b.rowStride, ldc)))
+                    {
+                        path = GemmPath::Jit;
+                        rate = model.jitRate;
+                    }
+                }
+                return {M, N, K, path, work / rate, 1.0};
+            }
+
+            auto share = [&](size_t blocks) { return parallel ? static_cast<double>(std::min(threads, blocks)) : 1.0; };
+            auto spread = [&](size_t blocks) { return share(blocks) > 1.0 ? model.parallelNs : 0.0; };
+
+            double cost[8];
+            std::fill(cost, cost + 8, never);
+            auto costOf = [&](GemmPath path) -> double& { return cost[static_cast<size_t>(path)]; };
+            double density = 1.0;
+
+            costOf(GemmPath::Unpacked) = work / unpackedRate;
+            if constexpr (plain)
+            {
+                if (generated)
+                    costOf(GemmPath::Jit) = work / model.jitRate;
+                if (N == 1 && a.colStride == 1 && b.rowStride == 1)
+                    costOf(GemmPath::Gemv) = (work / (model.gemvRate * share(M))) + spread(M);
+            }
+
+            slices = 1;
+            if (large || forced != GemmPath::Auto)
+            {
+                const double packing = ((static_cast<double>(M) * K + static_cast<double>(K) * N) / model.packRate) + model.packedCallNs;
+                const size_t rowBlocks = (M + B::MC - 1) / B::MC;
+                const size_t colBlocks = (N + B::NC - 1) / B::NC;
+                slices = kSlices<T>(M, N, K);
+                const size_t splitSlices = std::max<size_t>(slices, 2);
+                const double packedWork = work / (model.packedRate * filled(M, B::MR) * rowFill);
+                costOf(GemmPath::Packed) = (packedWork / share(rowBlocks)) + packing + spread(rowBlocks);
+                costOf(GemmPath::ColumnParallel) = (packedWork / share(colBlocks)) + packing + spread(colBlocks);
+                costOf(GemmPath::SplitK) = (packedWork / share(splitSlices)) + packing + spread(splitSlices)
+                    + (static_cast<double>(splitSlices) * M * N / model.packRate);
+                if constexpr (plain)
+                    if (config::sparseGemm || forced == GemmPath::SparseA)
+                    {
+                        if (large && forced == GemmPath::Auto)
+                            density = sampleDensity(M, K, a);
+                        const double scan = static_cast<double>(M) * K / model.scanRate;
+                        costOf(GemmPath::SparseA) = ((scan + (density * work / unpackedRate)) / share(M)) + spread(M);
+                    }
+            }
+
+            // A K split changes the summation order, so in deterministic mode it
+            // must not depend on the thread count through columnParallel().
+            const bool columns = large && columnParallel<T>(M, N, K);
+            const GemmPath packed = slices > 1 && (config::deterministic || !columns) ? GemmPath::SplitK
+                : columns ? GemmPath::ColumnParallel : GemmPath::Packed;
+            auto pick = [&]
+            {
+                if (forced != GemmPath::Auto && costOf(forced) < never)
+                    return forced;
+                GemmPath cheapest = GemmPath::Unpacked;
+                for (GemmPath candidate : {GemmPath::Jit, GemmPath::Gemv, GemmPath::SparseA, packed})
+                    if ((large || candidate == GemmPath::Jit || candidate == GemmPath::Gemv) && costOf(candidate) < costOf(cheapest))
+                        cheapest = candidate;
+                return cheapest;
+            };
+            GemmPath path = pick();
+            if constexpr (plain)
+                if (path == GemmPath::Jit && !(kernel = jit::kernel<T>(M, N, K, a.rowStride, b.rowStride, ldc)))
+                {
+                    // The shape is still warming up, the kernel cache is full or the host refused executable memory.
+                    costOf(GemmPath::Jit) = never;
+                    path = pick();
+                }
+            if (path == GemmPath::SplitK)
+                slices = std::max<size_t>(slices, 2);
+            return {M, N, K, path, costOf(path), density};
+        }
+
+        /**
+         * @brief C += A * B for strided operands, on the kernel chosen by chooseGemm().
+         *
+         * Reports the kernel run to config::gemmObserver.
+         */
+        template<typename T, typename S = PlusTimes<T>>
+        void gemmStrided(size_t M, size_t N, size_t K, Strided<T> a, Strided<T> b, T* c, size_t ldc)
+        {
+            size_t slices = 1;
+            jit::Kernel<T> kernel = nullptr;
+            const GemmDecision decision = chooseGemm<T, S>(M, N, K, a, b, ldc, slices, kernel);
+            if constexpr (std::is_same<S, PlusTimes<T>>::value)
+            {
+                if (decision.path == GemmPath::Jit)
+                    kernel(a.data, b.data, c);
+                else if (decision.path == GemmPath::Gemv)
+                    gemv<T>(M, K, a, b.data, c, ldc);
+                else if (decision.path == GemmPath::SparseA)
+                    gemmSkipZeros<T>(M, N, K, a, b, c, ldc);
+            }
+
+            if (decision.path == GemmPath::Unpacked)
+                gemmUnpacked<T, S>(M, N, K, a, b, c, ldc);
+            else if (decision.path == GemmPath::Packed)
+                gemmPackB<T, S>(M, N, K, a, b, c, ldc);
+            else if (decision.path == GemmPath::ColumnParallel)
+                gemmColumnBlocks<T, S>(M, N, K, a, b, c, ldc);
+            else if (decision.path == GemmPath::SplitK)
+                gemmSplitK<T, S>(M, N, K, slices, a, b, c, ldc);
+
+            if (config::gemmObserver)
+                config::gemmObserver(decision);
+        }
+
+        /**
+         * @brief C += A * B on row-major buffers; see gemmStrided().
+         */
+        template<typename T, typename S = PlusTimes<T>>
+        void gemm(size_t M, size_t N, size_t K,
+                  const T* a, size_t lda, const T* b, size_t ldb, T* c, size_t ldc)
+        {
+            gemmStrided<T, S>(M, N, K, Strided<T>{a, lda, 1}, Strided<T>{b, ldb, 1}, c, ldc);
+        }
+    }
+
+    /**
+     * @brief Measures the cost model parameters on this host and installs them in config::gemmCost.
+     *
+     * Times a few small float products of each kernel on the calling thread,
+     * a few milliseconds in all. The result can be saved and later assigned
+     * to config::gemmCost directly instead of measuring again.
+     *
+     * @return The measured parameters.
+     */
+    inline GemmCostModel tuneGemmCostModel()
+    {
+        using Clock = std::chrono::steady_clock;
+        using detail::Strided;
+        // Fastest of a few runs, in ns, never below 1 so rates stay finite.
+        auto fastest = [](auto&& run)
+        {
+            double best = std::numeric_limits<double>::infinity();
+            for (int r = 0; r < 5; ++r)
+            {
+                const auto start = Clock::now();
+                run();
+                best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+            }
+            return std::max(best, 1.0);
+        };
+
+        GemmCostModel model = config::gemmCost;
+        constexpr size_t n = 128;
+        std::vector<float> a(n * n, 1.0f), b(n * n, 0.5f), c(n * n, 0.0f);
+
+        constexpr size_t u = n;
+        model.unpackedRate = static_cast<double>(u * u * u)
+            / fastest([&] { detail::gemmRowMajor<float>(u, u, u, a.data(), n, b.data(), n, c.data(), n); });
+
+        constexpr size_t j = 24;
+        if (const detail::jit::Kernel<float> kernel = detail::jit::kernel<float>(j, j, j, n, n, n, 0))
+            model.jitRate = static_cast<double>(16 * j * j * j) / fastest([&]
+            {
+                for (int r = 0; r < 16; ++r)
+                    kernel(a.data(), b.data(), c.data());
+            });
+
+        model.gemvRate = static_cast<double>(n * n)
+            / fastest([&] { detail::gemv<float>(n, n, Strided<float>{a.data(), n, 1}, b.data(), c.data(), 1); });
+
+        // B of 2048 x 1024 floats, 8 MiB, past any L2.
+        constexpr size_t w = 1024, k = 2048;
+        std::vector<float> wide(k * w, 0.5f), rows(4 * w, 0.0f);
+        model.streamRate = static_cast<double>(4 * k * w)
+            / fastest([&] { detail::gemmRowMajor<float>(4, w, k, wide.data(), k, wide.data(), w, rows.data(), w); });
+
+        std::vector<float> zeros(n * n, 0.0f);
+        model.scanRate = static_cast<double>(n * n)
+            / fastest([&] { detail::gemmSkipZeros<float>(n, n, n, Strided<float>{zeros.data(), n, 1}, Strided<float>{b.data(), n, 1}, c.data(), n); });
+
+        std::vector<float> panel(n * n);
+        model.packRate = static_cast<double>(n * n)
+            / fastest([&] { detail::packB<float>(n, n, b.data(), n, 1, panel.data()); });
+
+        // Fixed cost from a tiny product, rate from one large enough to amortize it.
+        constexpr size_t s = 4, p = 120;
+        const Strided<float> as{a.data(), n, 1}, bs{b.data(), n, 1};
+        const double small = fastest([&] { detail::gemmPackB<float>(s, s, s, as, bs, c.data(), n); });
+        model.packedCallNs = std::max(0.0, small - (2.0 * s * s / model.packRate));
+        const double large = fastest([&] { detail::gemmPackB<float>(p, p, p, as, bs, c.data(), n); });
+        model.packedRate = static_cast<double>(p * p * p)
+            / std::max(1.0, large - model.packedCallNs - (2.0 * p * p / model.packRate));
+
+        if (detail::threadCount() > 1)
+            model.parallelNs = fastest([&] { detail::parallelFor(detail::threadCount(), 1, [](size_t, size_t) {}); });
+
+        config::gemmCost = model;
+        return model;
+    }
+}
@@ -0,0 +1,206 @@
+/**
+ * @file Hash.hpp
+ * @brief Fast streaming content hash used to key cached Tensor results.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Tensor
+{
+    namespace detail
+    {
+        /**
+         * @brief Streaming 64-bit hash in the style of XXH3.
+         *
+         * Eight 64-bit accumulators absorb 64-byte stripes with a 32x32->64
+         * multiply per lane and are scrambled every 1 KiB, so the inner loop maps
+         * onto two AVX2 registers (or vectorizes from the scalar form). The
+         * output is not interchangeable with the reference xxHash.
+         */
+        class ContentHasher
+        {
+        private:
+            static constexpr size_t stripeBytes = 64;
+            static constexpr size_t stripesPerBlock = 16;
+            static constexpr uint64_t prime32 = 0x9E3779B1ULL;
+            static constexpr uint64_t prime64a = 0x9E3779B185EBCA87ULL;
+            static constexpr uint64_t prime64b = 0xC2B2AE3D27D4EB4FULL;
+            static constexpr uint64_t prime64c = 0x165667919E3779F9ULL;
+
+            static constexpr uint64_t secret[16] = {
+                0x2CB0F69F4ABEA221ULL, 0x9417034723148989ULL, 0xDD555950609DFE03ULL, 0xDBAFB150DEB12800ULL,
+                0x7E789B2E6C442CB6ULL, 0xF41E5636C7E4F8C4ULL, 0x0959D150F8FBA7E4ULL, 0xA97316F13CDB9EEAULL,
+                0x74CD8258F9520068ULL, 0x55C74A62E116868BULL, 0xD2F4C799A2023CBDULL, 0xDF98CB79A37B51B9ULL,
+                0x396F5885524F3905ULL, 0xAF1D56386CA3B276ULL, 0xA9FFBE6B5104E85AULL, 0x6BD0C51B9FD533B3ULL
+            };
+
+            alignas(32) uint64_t acc[8];
+            unsigned char buffer[stripeBytes];
+            size_t buffered = 0;
+            size_t stripeInBlock = 0;
+            uint64_t totalBytes = 0;
+
+            static uint64_t mulFold(uint64_t a, uint64_t b)
+            {
+#if defined(__SIZEOF_INT128__)
+                __extension__ typedef unsigned __int128 u128;   // keeps -Wpedantic quiet
+                const u128 product = static_cast<u128>(a) * b;
+                return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+                const uint64_t aLo = a & 0xFFFFFFFFULL, aHi = a >> 32;
+                const uint64_t bLo = b & 0xFFFFFFFFULL, bHi = b >> 32;
+                const uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+                const uint64_t cross = (ll >> 32) + (lh & 0xFFFFFFFFULL) + hl;
+                const uint64_t lo = (cross << 32) | (ll & 0xFFFFFFFFULL);
+                const uint64_t hi = hh + (lh >> 32) + (cross >> 32);
+                return lo ^ hi;
+#endif
+            }
+
+            static uint64_t avalanche(uint64_t h)
+            {
+                h ^= h >> 37;
+                h *= prime64c;
+                h ^= h >> 32;
+                return h;
+            }
+
+            void accumulate(const unsigned char* stripe)
+            {
+                const uint64_t* key = secret + stripeInBlock % 8;
+#if defined(__AVX2__)
+                for (size_t half = 0; half < 2; ++half)
+                {
+                    __m256i* lane = reinterpret_cast<__m256i*>(acc) + half;
+                    const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe) + half);
+                    const __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + (half * 4)));
+                    const __m256i dk = _mm256_xor_si256(d, k);
+                    const __m256i product = _mm256_mul_epu32(dk, _mm256_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+                    const __m256i swapped = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+                    _mm256_store_si256(lane, _mm256_add_epi64(_mm256_load_si256(lane), _mm256_add_epi64(product, swapped)));
+                }
+#else
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    uint64_t value;
+                    std::memcpy(&value, stripe + (i * 8), sizeof value);
+                    const uint64_t keyed = value ^ key[i];
+                    acc[i ^ 1] += value;
+                    acc[i] += (keyed & 0xFFFFFFFFULL) * (keyed >> 32);
+                }
+#endif
+                if (++stripeInBlock == stripesPerBlock)
+                {
+                    scramble();
+                    stripeInBlock = 0;
+                }
+            }
+
+            void scramble()
+            {
+#if defined(__AVX2__)
+                const __m256i prime = _mm256_set1_epi32(static_cast<int>(prime32));
+                for (size_t half = 0; half < 2; ++half)
+                {
+                    __m256i* lane = reinterpret_cast<__m256i*>(acc) + half;
+                    __m256i a = _mm256_load_si256(lane);
+                    a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+                    a = _mm256_xor_si256(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret + 8 + (half * 4))));
+                    const __m256i lo = _mm256_mul_epu32(a, prime);
+                    const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+                    _mm256_store_si256(lane, _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+                }
+#else
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    acc[i] ^= acc[i] >> 47;
+                    acc[i] ^= secret[8 + i];
+                    acc[i] *= prime32;
+                }
+#endif
+            }
+
+        public:
+            /**
+             * @brief Starts a new hash.
+             *
+             * @param seed Value mixed into the initial state.
+             */
+            explicit ContentHasher(uint64_t seed = 0)
+            {
+                for (size_t i = 0; i < 8; ++i)
+                    acc[i] = secret[i] ^ (seed * prime64a) ^ (i * prime64b);
+            }
+
+            /**
+             * @brief Absorbs bytes; may be called any number of times.
+             *
+             * @param bytes Start of the data.
+             * @param length Number of bytes.
+             */
+            void update(const void* bytes, size_t length)
+            {
+                const unsigned char* p = static_cast<const unsigned char*>(bytes);
+                totalBytes += length;
+
+                if (buffered > 0)
+                {
+                    const size_t take = std::min(length, stripeBytes - buffered);
+                    std::memcpy(buffer + buffered, p, take);
+                    buffered += take;
+                    p += take;
+                    length -= take;
+                    if (buffered < stripeBytes)
+                        return;
+                    accumulate(buffer);
+                    buffered = 0;
+                }
+
+                for (; length >= stripeBytes; p += stripeBytes, length -= stripeBytes)
+                    accumulate(p);
+
+                std::memcpy(buffer, p, length);
+                buffered = length;
+            }
+
+            /**
+             * @brief Returns the hash of everything absorbed so far.
+             *
+             * @return 64-bit digest; the hasher can keep absorbing afterwards.
+             */
+            uint64_t digest() const
+            {
+                ContentHasher state = *this;
+                if (state.buffered > 0)
+                {
+                    std::memset(state.buffer + state.buffered, 0, stripeBytes - state.buffered);
+                    state.accumulate(state.buffer);
+                }
+
+                uint64_t h = totalBytes * prime64a;
+                for (size_t i = 0; i < 4; ++i)
+                    h += mulFold(state.acc[2 * i] ^ secret[(2 * i) + 1], state.acc[(2 * i) + 1] ^ secret[(2 * i) + 2]);
+                return avalanche(h);
+            }
+
+            /**
+             * @brief Hash of a single 64-bit word, used for per-element hash terms.
+             */
+            static uint64_t mixWord(uint64_t word, uint64_t position)
+            {
+                return avalanche(mulFold(word ^ secret[position & 15], position + prime64b) + position * prime64a);
+            }
+        };
+    }
+}
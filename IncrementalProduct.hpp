@@ -0,0 +1,288 @@
+/**
+ * @file IncrementalProduct.hpp
+ * @brief Keeps C = A * B up to date by recomputing only what writes to A and B affect.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    namespace config
+    {
+        /**
+         * @brief Fraction of a full product's multiply-adds above which an update recomputes it whole.
+         */
+        inline double incrementalFullFraction = 0.5;
+    }
+
+    /**
+     * @brief Counters reported by IncrementalProduct::stats().
+     */
+    struct IncrementalStats
+    {
+        uint64_t updates = 0;       ///< update() calls that found a change.
+        uint64_t full = 0;          ///< Of those, full recomputations.
+        uint64_t rows = 0;          ///< Rows of C recomputed exactly.
+        uint64_t cols = 0;          ///< Columns of C recomputed exactly.
+        uint64_t deltas = 0;        ///< Low-rank corrections applied.
+    };
+
+    /**
+     * @brief The product C = A * B, brought up to date after writes to A or B.
+     *
+     * update() asks each operand which lines were written since the last
+     * update (Tensor::writtenSince(), so enable Tensor::trackWrites() on
+     * them), keeps those whose elements differ from its copy of the operand,
+     * and touches only the output they reach:
+     *  - rows of A rewritten whole: those rows of C are recomputed,
+     *  - columns of B rewritten whole: those columns of C are recomputed,
+     *  - anything narrower, e.g. a few columns of A: a low-rank correction
+     *    C += dA * B_old + A * dB over the written rows x columns only.
+     *
+     * The corrections need the operands as of the last update, so the
+     * object keeps a copy of each. Corrections round differently from a
+     * fresh product; on floating point types call refresh() now and then to
+     * drop the drift. A read through the non-const operator() is reported
+     * as a write but changes nothing, so it costs the comparison only. The
+     * cached product references its operands; they must outlive it.
+     *
+     * @tparam T Numeric type.
+     * @tparam Layout Storage layout of the operands and the product.
+     */
+    template<typename T, typename Layout = RowMajor>
+    class IncrementalProduct
+    {
+    private:
+        using Matrix = Tensor<T, Layout>;
+
+        const Matrix& a;        ///< Left operand.
+        const Matrix& b;        ///< Right operand.
+        Matrix aSeen, bSeen;    ///< Operands as of the last update.
+        Matrix c;               ///< aSeen * bSeen.
+        uint64_t stamp;         ///< Writes after this haven't been applied.
+        uint64_t aVersion, bVersion;
+        IncrementalStats counters;
+
+        /// @brief Copies m(rowIndices, colIndices) into a dense matrix.
+        static Matrix gather(const Matrix& m, const std::vector<size_t>& rowIndices, const std::vector<size_t>& colIndices)
+        {
+            Matrix out(rowIndices.size(), colIndices.size());
+            const T* in = detail::TensorAccess::storage(m);
+            const size_t ld = detail::TensorAccess::leadingDim(m);
+            T* to = detail::TensorAccess::storage(out);
+            const size_t ldOut = detail::TensorAccess::leadingDim(out);
+            for (size_t r = 0; r < rowIndices.size(); ++r)
+                for (size_t q = 0; q < colIndices.size(); ++q)
+                    to[Layout::offset(r, q, ldOut)] = in[Layout::offset(rowIndices[r], colIndices[q], ld)];
+            return out;
+        }
+
+        /// @brief Same as gather(), subtracting the elements of base at the same positions.
+        static Matrix gatherDelta(const Matrix& m, const Matrix& base,
+                                  const std::vector<size_t>& rowIndices, const std::vector<size_t>& colIndices)
+        {
+            Matrix out = gather(m, rowIndices, colIndices);
+            T* to = detail::TensorAccess::storage(out);
+            const size_t ldOut = detail::TensorAccess::leadingDim(out);
+            const T* from = detail::TensorAccess::storage(base);
+            const size_t ld = detail::TensorAccess::leadingDim(base);
+            for (size_t r = 0; r < rowIndices.size(); ++r)
+                for (size_t q = 0; q < colIndices.size(); ++q)
+                    to[Layout::offset(r, q, ldOut)] -= from[Layout::offset(rowIndices[r], colIndices[q], ld)];
+            return out;
+        }
+
+        /// @brief m(rowIndices, colIndices) = part, or += part when accumulate.
+        static void scatter(Matrix& m, const Matrix& part, const std::vector<size_t>& rowIndices,
+                            const std::vector<size_t>& colIndices, bool accumulate)
+        {
+            T* to = detail::TensorAccess::storage(m);
+            const size_t ld = detail::TensorAccess::leadingDim(m);
+            const T* in = detail::TensorAccess::storage(part);
+            const size_t ldPart = detail::TensorAccess::leadingDim(part);
+            for (size_t r = 0; r < rowIndices.size(); ++r)
+                for (size_t q = 0; q < colIndices.size(); ++q)
+                {
+                    T& slot = to[Layout::offset(rowIndices[r], colIndices[q], ld)];
+                    const T value = in[Layout::offset(r, q, ldPart)];
+                    slot = accumulate ? static_cast<T>(slot + value) : value;
+                }
+        }
+
+        /// @brief Narrows written lines to the rows and columns where m still differs from seen.
+        static WrittenLines changed(const Matrix& m, const Matrix& seen, const WrittenLines& written)
+        {
+            WrittenLines out;
+            std::vector<char> colChanged(written.cols.size(), 0);
+            const T* now = detail::TensorAccess::storage(m);
+            const size_t ld = detail::TensorAccess::leadingDim(m);
+            const T* before = detail::TensorAccess::storage(seen);
+            const size_t ldSeen = detail::TensorAccess::leadingDim(seen);
+            for (size_t i : written.rows)
+            {
+                bool rowChanged = false;
+                for (size_t q = 0; q < written.cols.size(); ++q)
+                {
+                    const size_t j = written.cols[q];
+                    // Bitwise, so a rewritten NaN counts as unchanged and -0 as changed.
+                    if (std::memcmp(now + Layout::offset(i, j, ld), before + Layout::offset(i, j, ldSeen), sizeof(T)) != 0)
+                    {
+                        rowChanged = true;
+                        colChanged[q] = 1;
+                    }
+                }
+                if (rowChanged)
+                    out.rows.push_back(i);
+            }
+            for (size_t q = 0; q < written.cols.size(); ++q)
+                if (colChanged[q])
+                    out.cols.push_back(written.cols[q]);
+            return out;
+        }
+
+        static std::vector<size_t> allOf(size_t n)
+        {
+            std::vector<size_t> indices(n);
+            for (size_t i = 0; i < n; ++i)
+                indices[i] = i;
+            return indices;
+        }
+
+        void sync()
+        {
+            aVersion = a.version();
+            bVersion = b.version();
+        }
+
+    public:
+        /**
+         * @brief Computes A * B and starts following writes to A and B.
+         *
+         * @param left A; must outlive this object.
+         * @param right B; must outlive this object.
+         * @throws std::runtime_error if dimensions are incompatible.
+         */
+        IncrementalProduct(const Matrix& left, const Matrix& right)
+            : a(left), b(right), aSeen(left), bSeen(right), c(left * right), stamp(Matrix::writeStamp())
+        {
+            sync();
+        }
+
+        IncrementalProduct(const IncrementalProduct&) = delete;
+        IncrementalProduct& operator=(const IncrementalProduct&) = delete;
+
+        /**
+         * @brief Applies the writes made to A and B since the last update.
+         *
+         * Recomputes the whole product instead when the written lines would
+         * cost more than config::incrementalFullFraction of it.
+         *
+         * @return The up to date product.
+         * @throws std::runtime_error if an operand changed shape.
+         */
+        const Matrix& update()
+        {
+            if (a.version() == aVersion && b.version() == bVersion)
+                return c;
+            if (a.rowCount() != aSeen.rowCount() || a.colCount() != aSeen.colCount()
+                || b.rowCount() != bSeen.rowCount() || b.colCount() != bSeen.colCount())
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            const uint64_t next = Matrix::writeStamp();
+            // An untracked operand reports every line, so only ask the ones whose version moved.
+            const WrittenLines dA = a.version() != aVersion ? changed(a, aSeen, a.writtenSince(stamp)) : WrittenLines{};
+            const WrittenLines dB = b.version() != bVersion ? changed(b, bSeen, b.writtenSince(stamp)) : WrittenLines{};
+            stamp = next;
+            if (dA.rows.empty() && dB.rows.empty())
+            {
+                sync();
+                return c;
+            }
+            ++counters.updates;
+
+            const size_t M = a.rowCount(), K = a.colCount(), N = b.colCount();
+            // Whole rows of A and whole columns of B are recomputed exactly; narrower writes are corrected.
+            const bool rowsOfA = dA.cols.size() == K;
+            const bool colsOfB = dB.rows.size() == K;
+            const double work = (rowsOfA ? static_cast<double>(dA.rows.size()) * K * N : static_cast<double>(dA.rows.size()) * dA.cols.size() * N)
+                              + (colsOfB ? static_cast<double>(M) * K * dB.cols.size() : static_cast<double>(M) * dB.rows.size() * dB.cols.size());
+            if (work > config::incrementalFullFraction * M * K * N)
+            {
+                refresh();
+                return c;
+            }
+
+            const std::vector<size_t> everyRow = allOf(M), everyCol = allOf(N), everyK = allOf(K);
+            // C += dA * B_old + A_new * dB, with B_old read before bSeen takes the new B.
+            if (!rowsOfA && !dA.rows.empty() && !dA.cols.empty())
+            {
+                const Matrix delta = gatherDelta(a, aSeen, dA.rows, dA.cols);
+                scatter(c, delta * gather(bSeen, dA.cols, everyCol), dA.rows, everyCol, true);
+                ++counters.deltas;
+            }
+            if (!colsOfB && !dB.rows.empty() && !dB.cols.empty())
+            {
+                const Matrix delta = gatherDelta(b, bSeen, dB.rows, dB.cols);
+                scatter(c, gather(a, everyRow, dB.rows) * delta, everyRow, dB.cols, true);
+                ++counters.deltas;
+            }
+            if (rowsOfA && !dA.rows.empty())
+            {
+                scatter(c, gather(a, dA.rows, everyK) * b, dA.rows, everyCol, false);
+                counters.rows += dA.rows.size();
+            }
+            if (colsOfB && !dB.cols.empty())
+            {
+                scatter(c, a * gather(b, everyK, dB.cols), everyRow, dB.cols, false);
+                counters.cols += dB.cols.size();
+            }
+
+            if (!dA.rows.empty() && !dA.cols.empty())
+                scatter(aSeen, gather(a, dA.rows, dA.cols), dA.rows, dA.cols, false);
+            if (!dB.rows.empty() && !dB.cols.empty())
+                scatter(bSeen, gather(b, dB.rows, dB.cols), dB.rows, dB.cols, false);
+            sync();
+            return c;
+        }
+
+        /**
+         * @brief Recomputes the whole product from the current A and B.
+         *
+         * @return The product.
+         */
+        const Matrix& refresh()
+        {
+            stamp = Matrix::writeStamp();
+            aSeen = a;
+            bSeen = b;
+            c = a * b;
+            ++counters.full;
+            sync();
+            return c;
+        }
+
+        /**
+         * @brief Returns the product as of the last update, without applying newer writes.
+         *
+         * @return The product.
+         */
+        const Matrix& product() const { return c; }
+
+        /**
+         * @brief Returns the work counters.
+         *
+         * @return Updates, full recomputations and exactly recomputed lines.
+         */
+        IncrementalStats stats() const { return counters; }
+    };
+}
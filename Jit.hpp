@@ -0,0 +1,418 @@
+/**
+ * @file Jit.hpp
+ * @brief Run-time generated, fully unrolled x86-64 kernels for small fixed-shape products.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__linux__) && (defined(__GNUC__) || defined(__clang__))
+#include <sys/mman.h>
+#define TENSOR_HAS_JIT 1
+#else
+#define TENSOR_HAS_JIT 0
+#endif
+
+namespace Tensor
+{
+    namespace config
+    {
+        /**
+         * @brief Whether small float/double products run on generated kernels.
+         *
+         * Once a shape (M, N, K and leading dimensions) has come up
+         * config::jitMinUses times, an AVX2/FMA kernel is emitted for it with
+         * every loop unrolled and the accumulators fixed in registers, then
+         * reused. Needs an x86-64 Linux host whose CPU has AVX2 and FMA;
+         * elsewhere the compiled kernels are used. Never used in
+         * config::deterministic mode.
+         */
+        inline bool jitGemm = true;
+
+        /**
+         * @brief Products of a shape run on the compiled kernels before a kernel is generated for it.
+         *
+         * Emitting and mapping a kernel costs about as much as a few dozen
+         * small products, so a shape seen only a handful of times never pays
+         * it back. 0 or 1 generates on first use.
+         */
+        inline size_t jitMinUses = 16;
+
+        /// @brief Largest M, N or K a generated kernel is emitted for.
+        inline size_t jitMaxDim = 64;
+
+        /// @brief Largest M * N * K a generated kernel is emitted for; code grows by ~4 bytes per multiply-add.
+        inline size_t jitMaxWork = size_t{32} * 32 * 32;
+
+        /// @brief Number of shapes kernels are generated for; later shapes use the compiled kernels.
+        inline size_t jitMaxKernels = 256;
+    }
+
+    namespace detail
+    {
+        namespace jit
+        {
+            /**
+             * @brief Encoder for the handful of AVX2/FMA instructions the kernels use.
+             *
+             * Every vector instruction is emitted with the 3-byte VEX prefix and
+             * 256-bit length; memory operands are [base + disp] on a general
+             * register below r8 other than rsp and rbp.
+             */
+            class Assembler
+            {
+            private:
+                std::vector<uint8_t> code;
+
+                enum : unsigned { map0F = 1, map0F38 = 2 };
+                enum : unsigned { ppNone = 0, pp66 = 1, ppF3 = 2 };
+
+                void vex(unsigned map, unsigned pp, bool w, unsigned reg, unsigned vvvv, unsigned rm)
+                {
+                    code.push_back(0xC4);
+                    code.push_back(static_cast<uint8_t>((((~reg >> 3) & 1) << 7) | (1 << 6) | (((~rm >> 3) & 1) << 5) | map));
+                    code.push_back(static_cast<uint8_t>((unsigned{w} << 7) | ((~vvvv & 0xF) << 3) | (1 << 2) | pp));
+                }
+
+                void memory(unsigned reg, unsigned base, int32_t disp)
+                {
+                    if (disp >= -128 && disp < 128)
+                    {
+                        code.push_back(static_cast<uint8_t>(0x40 | ((reg & 7) << 3) | base));
+                        code.push_back(static_cast<uint8_t>(disp));
+                        return;
+                    }
+                    code.push_back(static_cast<uint8_t>(0x80 | ((reg & 7) << 3) | base));
+                    append32(static_cast<uint32_t>(disp));
+                }
+
+                void append32(uint32_t value)
+                {
+                    for (int byte = 0; byte < 4; ++byte)
+                        code.push_back(static_cast<uint8_t>(value >> (8 * byte)));
+                }
+
+            public:
+                static constexpr unsigned rdx = 2, rsi = 6, rdi = 7;
+
+                /// @brief Appends raw bytes (constants placed ahead of the code).
+                void data(const void* bytes, size_t count)
+                {
+                    const uint8_t* p = static_cast<const uint8_t*>(bytes);
+                    code.insert(code.end(), p, p + count);
+                }
+
+                size_t size() const { return code.size(); }
+                const uint8_t* bytes() const { return code.data(); }
+
+                /// @brief vmovups / vmovupd dst, [base + disp].
+                void load(bool dbl, unsigned dst, unsigned base, int32_t disp)
+                {
+                    vex(map0F, dbl ? pp66 : ppNone, false, dst, 0, base);
+                    code.push_back(0x10);
+                    memory(dst, base, disp);
+                }
+
+                /// @brief vmovups / vmovupd [base + disp], src.
+                void store(bool dbl, unsigned src, unsigned base, int32_t disp)
+                {
+                    vex(map0F, dbl ? pp66 : ppNone, false, src, 0, base);
+                    code.push_back(0x11);
+                    memory(src, base, disp);
+                }
+
+                /// @brief vmaskmovps / vmaskmovpd dst, mask, [base + disp]; masked-off lanes read as zero.
+                void maskLoad(bool dbl, unsigned dst, unsigned mask, unsigned base, int32_t disp)
+                {
+                    vex(map0F38, pp66, false, dst, mask, base);
+                    code.push_back(dbl ? 0x2D : 0x2C);
+                    memory(dst, base, disp);
+                }
+
+                /// @brief vmaskmovps / vmaskmovpd [base + disp], mask, src.
+                void maskStore(bool dbl, unsigned src, unsigned mask, unsigned base, int32_t disp)
+                {
+                    vex(map0F38, pp66, false, src, mask, base);
+                    code.push_back(dbl ? 0x2F : 0x2E);
+                    memory(src, base, disp);
+                }
+
+                /// @brief vbroadcastss / vbroadcastsd dst, [base + disp].
+                void broadcast(bool dbl, unsigned dst, unsigned base, int32_t disp)
+                {
+                    vex(map0F38, pp66, false, dst, 0, base);
+                    code.push_back(dbl ? 0x19 : 0x18);
+                    memory(dst, base, disp);
+                }
+
+                /// @brief vfmadd231ps / vfmadd231pd dst, a, b: dst += a * b.
+                void fma(bool dbl, unsigned dst, unsigned a, unsigned b)
+                {
+                    vex(map0F38, pp66, dbl, dst, a, b);
+                    code.push_back(0xB8);
+                    code.push_back(static_cast<uint8_t>(0xC0 | ((dst & 7) << 3) | (b & 7)));
+                }
+
+                /// @brief vmovdqu dst, [rip + (target - end of instruction)].
+                void loadRelative(unsigned dst, size_t target)
+                {
+                    vex(map0F, ppF3, false, dst, 0, 0);
+                    code.push_back(0x6F);
+                    code.push_back(static_cast<uint8_t>(((dst & 7) << 3) | 5));
+                    append32(static_cast<uint32_t>(static_cast<int64_t>(target) - static_cast<int64_t>(code.size() + 4)));
+                }
+
+                /// @brief vzeroupper; ret.
+                void leave()
+                {
+                    const uint8_t tail[] = {0xC5, 0xF8, 0x77, 0xC3};
+                    data(tail, sizeof(tail));
+                }
+            };
+
+            /**
+             * @brief Page-granular copy of generated code, mapped read + execute.
+             */
+            class ExecutableCode
+            {
+            private:
+                void* memory = nullptr;
+                size_t length = 0;
+
+            public:
+                ExecutableCode(const uint8_t* bytes, size_t count)
+                {
+#if TENSOR_HAS_JIT
+                    void* p = mmap(nullptr, count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (p == MAP_FAILED)
+                        return;
+                    std::memcpy(p, bytes, count);
+                    if (mprotect(p, count, PROT_READ | PROT_EXEC) != 0)
+                    {
+                        munmap(p, count);
+                        return;
+                    }
+                    memory = p;
+                    length = count;
+#else
+                    (void)bytes;
+                    (void)count;
+#endif
+                }
+
+                ExecutableCode(const ExecutableCode&) = delete;
+                ExecutableCode& operator=(const ExecutableCode&) = delete;
+
+                ~ExecutableCode()
+                {
+#if TENSOR_HAS_JIT
+                    if (memory)
+                        munmap(memory, length);
+#endif
+                }
+
+                /// @brief Start of the code, or nullptr if mapping failed.
+                const uint8_t* base() const { return static_cast<const uint8_t*>(memory); }
+            };
+
+            /// @brief A generated C += A * B for one shape; operands are passed as (a, b, c).
+            template<typename T>
+            using Kernel = void (*)(const T*, const T*, T*);
+
+            /// @brief Shape and leading dimensions a kernel is specialized for.
+            using Shape = std::tuple<size_t, size_t, size_t, size_t, size_t, size_t>;
+
+            /**
+             * @brief Emits the kernel for C (M x N, ldc) += A (M x K, lda) * B (K x N, ldb), row-major.
+             *
+             * C is walked in blocks of up to MR = 6 rows and two vectors of
+             * columns, whose twelve accumulators stay in ymm0-11 for the whole
+             * K loop; ymm12-13 hold the current row slice of B, ymm14 the
+             * broadcast element of A and ymm15 the lane mask of a ragged last
+             * vector, read from a constant placed before the code.
+             *
+             * @return Bytes of the kernel; the entry point is at codeOffset.
+             */
+            template<typename T>
+            Assembler emit(size_t M, size_t N, size_t K, size_t lda, size_t ldb, size_t ldc, size_t& codeOffset)
+            {
+                constexpr bool dbl = std::is_same<T, double>::value;
+                constexpr size_t W = 32 / sizeof(T);
+                constexpr size_t MR = 6, NV = 2;
+                constexpr unsigned bReg = 12, aReg = 14, maskReg = 15;
+                const size_t vectors = (N + W - 1) / W;
+                const size_t tail = N % W;
+
+                Assembler as;
+                alignas(32) int32_t mask[8] = {};
+                for (size_t lane = 0; lane < tail * sizeof(T) / 4; ++lane)
+                    mask[lane] = -1;
+                as.data(mask, sizeof(mask));
+                codeOffset = as.size();
+                if (tail != 0)
+                    as.loadRelative(maskReg, 0);
+
+                // eligible() keeps every offset within an int32 displacement.
+                auto disp = [](size_t elements) { return static_cast<int32_t>(elements * sizeof(T)); };
+                for (size_t v0 = 0; v0 < vectors; v0 += NV)
+                {
+                    const size_t nv = std::min(NV, vectors - v0);
+                    auto ragged = [&](size_t v) { return tail != 0 && v0 + v == vectors - 1; };
+                    for (size_t i0 = 0; i0 < M; i0 += MR)
+                    {
+                        const size_t mr = std::min(MR, M - i0);
+                        auto acc = [&](size_t r, size_t v) { return static_cast<unsigned>((r * NV) + v); };
+
+                        for (size_t r = 0; r < mr; ++r)
+                            for (size_t v = 0; v < nv; ++v)
+                            {
+                                const int32_t at = disp(((i0 + r) * ldc) + ((v0 + v) * W));
+                                if (ragged(v))
+                                    as.maskLoad(dbl, acc(r, v), maskReg, Assembler::rdx, at);
+                                else
+                                    as.load(dbl, acc(r, v), Assembler::rdx, at);
+                            }
+
+                        for (size_t k = 0; k < K; ++k)
+                        {
+                            for (size_t v = 0; v < nv; ++v)
+                            {
+                                const int32_t at = disp((k * ldb) + ((v0 + v) * W));
+                                if (ragged(v))
+                                    as.maskLoad(dbl, bReg + static_cast<unsigned>(v), maskReg, Assembler::rsi, at);
+                                else
+                                    as.load(dbl, bReg + static_cast<unsigned>(v), Assembler::rsi, at);
+                            }
+                            for (size_t r = 0; r < mr; ++r)
+                            {
+                                as.broadcast(dbl, aReg, Assembler::rdi, disp(((i0 + r) * lda) + k));
+                                for (size_t v = 0; v < nv; ++v)
+                                    as.fma(dbl, acc(r, v), aReg, bReg + static_cast<unsigned>(v));
+                            }
+                        }
+
+                        for (size_t r = 0; r < mr; ++r)
+                            for (size_t v = 0; v < nv; ++v)
+                            {
+                                const int32_t at = disp(((i0 + r) * ldc) + ((v0 + v) * W));
+                                if (ragged(v))
+                                    as.maskStore(dbl, acc(r, v), maskReg, Assembler::rdx, at);
+                                else
+                                    as.store(dbl, acc(r, v), Assembler::rdx, at);
+                            }
+                    }
+                }
+                as.leave();
+                return as;
+            }
+
+            /// @brief Whether this build and CPU can run generated kernels.
+            inline bool supported()
+            {
+#if TENSOR_HAS_JIT
+                static const bool cpu = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+                return cpu;
+#else
+                return false;
+#endif
+            }
+
+            /// @brief Whether element offsets up to (rows - 1) * ld + cols fit a signed 32-bit byte displacement.
+            template<typename T>
+            bool addressable(size_t rows, size_t ld, size_t cols)
+            {
+                const size_t limit = static_cast<size_t>(std::numeric_limits<int32_t>::max()) / sizeof(T);
+                return ld <= limit && ((rows - 1) * ld) + cols <= limit;
+            }
+
+            /**
+             * @brief Whether kernels are generated for this shape on this host (config and CPU allowing).
+             *
+             * Every operand is addressed as [base + disp32], so leading
+             * dimensions whose last row starts 2 GiB or more past the base
+             * are left to the compiled kernels.
+             */
+            template<typename T>
+            bool eligible(size_t M, size_t N, size_t K, size_t lda, size_t ldb, size_t ldc)
+            {
+                if constexpr (!std::is_same<T, float>::value && !std::is_same<T, double>::value)
+                    return false;
+                else
+                    return config::jitGemm && M > 0 && N > 0 && K > 0
+                        && M <= config::jitMaxDim && N <= config::jitMaxDim && K <= config::jitMaxDim
+                        && M * N * K <= config::jitMaxWork
+                        && addressable<T>(M, lda, K) && addressable<T>(K, ldb, N) && addressable<T>(M, ldc, N)
+                        && supported();
+            }
+
+            /**
+             * @brief Returns the generated kernel for a shape, emitting it on its minUses-th request.
+             *
+             * Kernels live until exit. Requests for shapes without a kernel
+             * are counted in a table that is cleared when it outgrows
+             * config::jitMaxKernels, so only shapes that keep coming back
+             * are compiled. A one-entry thread-local memo skips the lock when
+             * the same shape repeats, the case this exists for.
+             *
+             * @param minUses Requests before the kernel is emitted, config::jitMinUses by default.
+             * @return The kernel, or nullptr if the shape or host is not eligible or the shape is still warming up.
+             */
+            template<typename T>
+            Kernel<T> kernel(size_t M, size_t N, size_t K, size_t lda, size_t ldb, size_t ldc,
+                             size_t minUses = config::jitMinUses)
+            {
+                if constexpr (!std::is_same<T, float>::value && !std::is_same<T, double>::value)
+                    return nullptr;
+                else
+                {
+                    if (!eligible<T>(M, N, K, lda, ldb, ldc))
+                        return nullptr;
+
+                    const Shape shape{M, N, K, lda, ldb, ldc};
+                    thread_local Shape lastShape{};
+                    thread_local Kernel<T> lastKernel = nullptr;
+                    if (lastKernel && shape == lastShape)
+                        return lastKernel;
+
+                    static std::mutex mutex;
+                    static std::map<Shape, std::pair<std::unique_ptr<ExecutableCode>, size_t>> kernels;
+                    static std::map<Shape, size_t> requests;
+                    std::lock_guard<std::mutex> lock(mutex);
+                    auto found = kernels.find(shape);
+                    if (found == kernels.end())
+                    {
+                        if (kernels.size() >= config::jitMaxKernels)
+                            return nullptr;
+                        if (requests.size() >= config::jitMaxKernels && !requests.count(shape))
+                            requests.clear();
+                        if (++requests[shape] < minUses)
+                            return nullptr;
+                        requests.erase(shape);
+                        size_t entry = 0;
+                        const Assembler code = emit<T>(M, N, K, lda, ldb, ldc, entry);
+                        found = kernels.emplace(shape, std::make_pair(std::make_unique<ExecutableCode>(code.bytes(), code.size()), entry)).first;
+                    }
+                    const uint8_t* base = found->second.first->base();
+                    if (!base)
+                        return nullptr;
+                    lastShape = shape;
+                    lastKernel = reinterpret_cast<Kernel<T>>(const_cast<uint8_t*>(base + found->second.second));
+                    return lastKernel;
+                }
+            }
+        }
+    }
+}
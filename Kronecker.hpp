@@ -0,0 +1,103 @@
+/**
+ * @file Kronecker.hpp
+ * @brief Lazy Kronecker product that is applied without being materialized.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    /**
+     * @brief Represents A (x) B without forming its (ma * mb) x (na * nb) elements.
+     *
+     * Products use the identity (A (x) B) vec(X) = vec(A * X * B^T), with vec
+     * stacking rows, so applying the view to a vector costs two small matrix
+     * products, O(ma * na * nb + ma * nb * mb), instead of O(ma * mb * na * nb).
+     * The view references its operands; they must outlive it.
+     *
+     * @tparam T Numeric type.
+     * @tparam Layout Storage layout of the operands.
+     */
+    template<typename T, typename Layout = RowMajor>
+    class KroneckerView
+    {
+    private:
+        const Tensor<T, Layout>& left;     ///< A.
+        const Tensor<T, Layout>& right;    ///< B.
+
+    public:
+        /**
+         * @brief Creates the view A (x) B.
+         *
+         * @param a Left factor.
+         * @param b Right factor.
+         */
+        KroneckerView(const Tensor<T, Layout>& a, const Tensor<T, Layout>& b)
+            : left(a), right(b)
+        {
+        }
+
+        /**
+         * @brief Returns the number of rows of A (x) B.
+         *
+         * @return Number of rows.
+         */
+        size_t rowCount() const { return left.rowCount() * right.rowCount(); }
+
+        /**
+         * @brief Returns the number of columns of A (x) B.
+         *
+         * @return Number of columns.
+         */
+        size_t colCount() const { return left.colCount() * right.colCount(); }
+
+        /**
+         * @brief Multiplies the view with a matrix, column by column.
+         *
+         * @param x Matrix with colCount() rows.
+         * @return (A (x) B) * x.
+         * @throws std::runtime_error if dimensions are incompatible.
+         */
+        Tensor<T, Layout> operator*(const Tensor<T, Layout>& x) const
+        {
+            if(x.rowCount() != colCount())
+                TENSOR_THROW(std::runtime_error, "Matrix dimensions incompatible for multiplication");
+
+            const size_t na = left.colCount(), nb = right.colCount();
+            const size_t ma = left.rowCount(), mb = right.rowCount();
+            const Tensor<T, Layout> rightT = right.transpose();
+
+            Tensor<T, Layout> result(rowCount(), x.colCount());
+            Tensor<T, Layout> reshaped(na, nb);
+            for (size_t c = 0; c < x.colCount(); ++c)
+            {
+                for (size_t j = 0; j < na; ++j)
+                    for (size_t q = 0; q < nb; ++q)
+                        reshaped(j, q) = x((j * nb) + q, c);
+
+                const Tensor<T, Layout> y = left * reshaped * rightT;
+                for (size_t i = 0; i < ma; ++i)
+                    for (size_t p = 0; p < mb; ++p)
+                        result((i * mb) + p, c) = y(i, p);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Forms the full product.
+         *
+         * @return A.kron(B).
+         */
+        Tensor<T, Layout> materialize() const
+        {
+            return left.kron(right);
+        }
+    };
+}
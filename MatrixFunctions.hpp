@@ -0,0 +1,212 @@
+/**
+ * @file MatrixFunctions.hpp
+ * @brief Matrix power and matrix exponential built on the Tensor product kernels.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Factorization.hpp"
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    namespace detail
+    {
+        /// @brief acc + alpha * x, element-wise.
+        template<typename T, typename Layout>
+        Tensor<T, Layout> addScaled(const Tensor<T, Layout>& acc, const Tensor<T, Layout>& x, T alpha)
+        {
+            return acc.elementWiseOp(x * alpha, std::plus<T>());
+        }
+
+        /// @brief Maximum absolute column sum.
+        template<typename T, typename Layout>
+        T norm1(const Tensor<T, Layout>& a)
+        {
+            T best = T{0};
+            for (size_t j = 0; j < a.colCount(); ++j)
+            {
+                T sum = T{0};
+                for (size_t i = 0; i < a.rowCount(); ++i)
+                    sum += std::abs(a(i, j));
+                best = std::max(best, sum);
+            }
+            return best;
+        }
+    }
+
+    /**
+     * @brief Raises a square matrix to a non-negative integer power.
+     *
+     * Uses repeated squaring, O(log n) products, ping-ponging between three
+     * buffers allocated up front, so no step allocates.
+     *
+     * @param a Square matrix.
+     * @param n Exponent; 0 yields the identity.
+     * @return a^n.
+     * @throws std::runtime_error if a is not square.
+     */
+    template<typename T, typename Layout>
+    Tensor<T, Layout> pow(const Tensor<T, Layout>& a, uint64_t n)
+    {
+        if(a.rowCount() != a.colCount())
+            TENSOR_THROW(std::runtime_error, "Matrix is not square");
+        if (n == 0)
+            return Tensor<T, Layout>::eye(a.rowCount());
+
+        Tensor<T, Layout> base = a;
+        Tensor<T, Layout> scratch(a.rowCount(), a.colCount());
+
+        // Square up to the lowest set bit so the result starts as a copy rather than I * base.
+        while ((n & 1) == 0)
+        {
+            base.multiplyInto(base, scratch);
+            std::swap(base, scratch);
+            n >>= 1;
+        }
+        Tensor<T, Layout> result = base;
+        n >>= 1;
+
+        while (n > 0)
+        {
+            base.multiplyInto(base, scratch);
+            std::swap(base, scratch);
+            if (n & 1)
+            {
+                result.multiplyInto(base, scratch);
+                std::swap(result, scratch);
+            }
+            n >>= 1;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Matrix exponential by scaling and squaring with a Pade approximant.
+     *
+     * Follows Higham (2005): picks the lowest Pade degree whose backward error
+     * bound covers the 1-norm of a, otherwise scales a by 2^-s, applies the
+     * degree 13 approximant (degree 7 for float) and squares s times. The
+     * products run on the same kernels as operator*.
+     *
+     * @param a Square matrix.
+     * @return e^a; every element NaN if a has a NaN or infinite element.
+     * @throws std::runtime_error if a is not square.
+     */
+    template<typename T, typename Layout>
+    Tensor<T, Layout> expm(const Tensor<T, Layout>& a)
+    {
+        static_assert(std::is_floating_point<T>::value, "expm requires a floating point type");
+        if(a.rowCount() != a.colCount())
+            TENSOR_THROW(std::runtime_error, "Matrix is not square");
+
+        using detail::addScaled;
+        using Matrix = Tensor<T, Layout>;
+        const size_t n = a.rowCount();
+        const Matrix identity = Matrix::eye(n);
+
+        // Pade coefficients b_0..b_m of each degree m.
+        static constexpr double pade3[] = {120, 60, 12, 1};
+        static constexpr double pade5[] = {30240, 15120, 3360, 420, 30, 1};
+        static constexpr double pade7[] = {17297280, 8648640, 1995840, 277200, 25200, 1512, 56, 1};
+        static constexpr double pade9[] = {17643225600, 8821612800, 2075673600, 302702400, 30270240,
+                                           2162160, 110880, 3960, 90, 1};
+        static constexpr double pade13[] = {64764752532480000, 32382376266240000, 7771770303897600,
+                                            1187353796428800, 129060195264000, 10559470521600,
+                                            670442572800, 33522128640, 1323241920, 40840800,
+                                            960960, 16380, 182, 1};
+
+        struct Degree
+        {
+            size_t m;
+            const double* b;
+            double theta;   ///< Largest 1-norm for which degree m meets unit roundoff.
+        };
+        static constexpr Degree doubleDegrees[] = {{3, pade3, 1.495585217958292e-2}, {5, pade5, 2.539398330063230e-1},
+                                                   {7, pade7, 9.504178996162932e-1}, {9, pade9, 2.097847961257068},
+                                                   {13, pade13, 5.371920351148152}};
+        static constexpr Degree floatDegrees[] = {{3, pade3, 4.258730016922831e-1}, {5, pade5, 1.880152677804762},
+                                                  {7, pade7, 3.925724783138660}};
+        constexpr bool single = sizeof(T) <= sizeof(float);
+        const Degree* degrees = single ? floatDegrees : doubleDegrees;
+        const size_t degreeCount = single ? std::size(floatDegrees) : std::size(doubleDegrees);
+
+        // Odd part U = x * sum b_{2j+1} x^{2j} and even part V = sum b_{2j} x^{2j} of the approximant.
+        auto padeTerms = [&](const Matrix& x, const Degree& degree) -> std::pair<Matrix, Matrix>
+        {
+            const double* b = degree.b;
+            const Matrix x2 = x * x;
+            if (degree.m == 13)
+            {
+                const Matrix x4 = x2 * x2;
+                const Matrix x6 = x4 * x2;
+                Matrix highU = addScaled(addScaled(x6 * static_cast<T>(b[13]), x4, static_cast<T>(b[11])), x2, static_cast<T>(b[9]));
+                Matrix lowU = addScaled(addScaled(addScaled(identity * static_cast<T>(b[1]), x6, static_cast<T>(b[7])),
+                                                  x4, static_cast<T>(b[5])), x2, static_cast<T>(b[3]));
+                Matrix highV = addScaled(addScaled(x6 * static_cast<T>(b[12]), x4, static_cast<T>(b[10])), x2, static_cast<T>(b[8]));
+                Matrix lowV = addScaled(addScaled(addScaled(identity * static_cast<T>(b[0]), x6, static_cast<T>(b[6])),
+                                                  x4, static_cast<T>(b[4])), x2, static_cast<T>(b[2]));
+                Matrix u = x * (x6 * highU).elementWiseOp(lowU, std::plus<T>());
+                Matrix v = (x6 * highV).elementWiseOp(lowV, std::plus<T>());
+                return {std::move(u), std::move(v)};
+            }
+
+            Matrix oddSum = identity * static_cast<T>(b[1]);
+            Matrix v = identity * static_cast<T>(b[0]);
+            Matrix power = x2;
+            for (size_t k = 2; k <= degree.m; k += 2)
+            {
+                if (k > 2)
+                    power = power * x2;
+                v = addScaled(v, power, static_cast<T>(b[k]));
+                oddSum = addScaled(oddSum, power, static_cast<T>(b[k + 1]));
+            }
+            return {x * oddSum, std::move(v)};
+        };
+
+        auto rational = [&](const Matrix& x, const Degree& degree)
+        {
+            auto [u, v] = padeTerms(x, degree);
+            const Matrix numerator = v.elementWiseOp(u, std::plus<T>());
+            const Matrix denominator = v.elementWiseOp(u, std::minus<T>());
+            return LU<T>(denominator).solve(numerator);
+        };
+
+        const double norm = static_cast<double>(detail::norm1(a));
+        if (!std::isfinite(norm))
+        {
+            // No scaling brings an infinite norm into range, and the squaring count below would overflow.
+            Matrix undefined(n, n);
+            undefined.fill(std::numeric_limits<T>::quiet_NaN());
+            return undefined;
+        }
+        for (size_t d = 0; d + 1 < degreeCount; ++d)
+            if (norm <= degrees[d].theta)
+                return rational(a, degrees[d]);
+
+        const Degree& top = degrees[degreeCount - 1];
+        const int squarings = norm > top.theta ? static_cast<int>(std::ceil(std::log2(norm / top.theta))) : 0;
+        Matrix result = rational(a * static_cast<T>(std::ldexp(1.0, -squarings)), top);
+
+        Matrix scratch(n, n);
+        for (int i = 0; i < squarings; ++i)
+        {
+            result.multiplyInto(result, scratch);
+            std::swap(result, scratch);
+        }
+        return result;
+    }
+}
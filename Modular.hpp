@@ -0,0 +1,330 @@
+/**
+ * @file Modular.hpp
+ * @brief Matrix product of unsigned 32-bit integers modulo p.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "Gemm.hpp"
+#include "Parallel.hpp"
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    /**
+     * @brief A modulus p with its Barrett constant and lazy-reduction bounds.
+     *
+     * Reducing after every multiply-add would cost more than the product
+     * itself. Instead the kernels sum lazyTerms() products of reduced values
+     * in 64 bits (or exactTerms() in doubles) before one Barrett reduction.
+     */
+    class Modulus
+    {
+    private:
+        uint32_t p;          ///< The modulus.
+        uint64_t barrett;    ///< floor((2^64 - 1) / p).
+
+    public:
+        /**
+         * @brief Prepares reductions modulo p.
+         *
+         * @param p Modulus; need not be prime for products, only for inverses elsewhere.
+         * @throws std::invalid_argument if p < 2.
+         */
+        explicit Modulus(uint32_t p)
+            : p(p), barrett(p < 2 ? 0 : std::numeric_limits<uint64_t>::max() / p)
+        {
+            if (p < 2)
+                TENSOR_THROW(std::invalid_argument, "Modulus must be at least 2");
+        }
+
+        /**
+         * @brief Returns p.
+         *
+         * @return The modulus.
+         */
+        constexpr uint32_t value() const { return p; }
+
+        /**
+         * @brief Reduces a 64-bit value modulo p.
+         *
+         * @param x Value to reduce.
+         * @return x mod p.
+         */
+        uint32_t reduce(uint64_t x) const
+        {
+#if defined(__SIZEOF_INT128__)
+            __extension__ typedef unsigned __int128 u128;   // keeps -Wpedantic quiet
+            const uint64_t q = static_cast<uint64_t>((static_cast<u128>(x) * barrett) >> 64);
+            uint64_t r = x - (q * p);
+            while (r >= p)
+                r -= p;
+            return static_cast<uint32_t>(r);
+#else
+            return static_cast<uint32_t>(x % p);
+#endif
+        }
+
+        /**
+         * @brief Number of products of reduced values a 64-bit sum below p can absorb.
+         *
+         * @return At least 1.
+         */
+        uint64_t lazyTerms() const
+        {
+            const uint64_t largest = uint64_t{p - 1} * (p - 1);
+            return std::max<uint64_t>(1, (std::numeric_limits<uint64_t>::max() - p) / std::max<uint64_t>(largest, 1));
+        }
+
+        /**
+         * @brief Number of products of reduced values a double sum below p holds exactly.
+         *
+         * @return 0 if not even one product stays below 2^53.
+         */
+        uint64_t exactTerms() const
+        {
+            const uint64_t limit = uint64_t{1} << 53;
+            const uint64_t largest = uint64_t{p - 1} * (p - 1);
+            return largest + p > limit ? 0 : (limit - p) / std::max<uint64_t>(largest, 1);
+        }
+    };
+
+    namespace config
+    {
+        /**
+         * @brief Smallest Modulus::exactTerms() for which modular products run on the double kernels.
+         *
+         * Small moduli let whole K slices accumulate exactly in doubles, so the
+         * vectorized packed GEMM does the work and a reduction follows each
+         * slice. Larger moduli use the 64-bit integer kernel.
+         */
+        inline uint64_t modularDoubleTerms = 64;
+    }
+
+    namespace detail
+    {
+        /// @brief Row-major copy of a with every element reduced modulo p.
+        template<typename T, typename Layout>
+        std::vector<T> reducedRowMajor(const Tensor<uint32_t, Layout>& a, const Modulus& modulus)
+        {
+            std::vector<T> out(a.rowCount() * a.colCount());
+            const uint32_t* values = TensorAccess::storage(a);
+            const size_t ld = TensorAccess::leadingDim(a);
+            for (size_t i = 0; i < a.rowCount(); ++i)
+                for (size_t j = 0; j < a.colCount(); ++j)
+                    out[(i * a.colCount()) + j] = static_cast<T>(values[Layout::offset(i, j, ld)] % modulus.value());
+            return out;
+        }
+
+        /**
+         * @brief C = A * B mod p on dense row-major doubles holding reduced values.
+         *
+         * K is cut into slices of Modulus::exactTerms() so every partial sum is
+         * an exact integer; C is reduced after each slice.
+         */
+        inline void gemmModDouble(size_t M, size_t N, size_t K, const double* a, const double* b,
+                                  uint32_t* c, const Modulus& modulus)
+        {
+            const double p = modulus.value();
+            const size_t slice = static_cast<size_t>(std::min<uint64_t>(modulus.exactTerms(), K));
+            std::vector<double> acc(M * N, 0.0);
+            for (size_t k0 = 0; k0 < K; k0 += slice)
+            {
+                gemm(M, N, std::min(slice, K - k0), a + k0, K, b + (k0 * N), N, acc.data(), N);
+                for (double& x : acc)
+                {
+                    // floor(x / p) * p is exact; the rounded quotient is off by at most one.
+                    x -= std::floor(x / p) * p;
+                    x += x < 0.0 ? p : (x >= p ? -p : 0.0);
+                }
+            }
+            for (size_t e = 0; e < M * N; ++e)
+                c[e] = static_cast<uint32_t>(acc[e]);
+        }
+
+        /**
+         * @brief acc[j] += a * b[j] (low) or, when high is given, low[j] += a * (b[j] & 0xFFFF)
+         *        and high[j] += a * (b[j] >> 16), for j in [0, n), in 64 bits.
+         *
+         * Spelled out with 32x32->64 multiplies (vpmuludq) because the widening
+         * loop isn't vectorized at -O2.
+         */
+        inline void mulAddWide(uint64_t* low, uint64_t* high, uint64_t a, const uint32_t* b, size_t n)
+        {
+            size_t j = 0;
+#if defined(__AVX512F__)
+            const __m512i av = _mm512_set1_epi64(static_cast<long long>(a));
+            const __m512i lowMask = _mm512_set1_epi64(0xFFFF);
+            for (; j + 8 <= n; j += 8)
+            {
+                const __m512i bv = _mm512_maskz_cvtepu32_epi64(0xFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j)));
+                if (high)
+                {
+                    const __m512i hv = _mm512_mask_srli_epi64(bv, 0xFF, bv, 16);
+                    const __m512i lv = _mm512_and_si512(bv, lowMask);
+                    _mm512_storeu_si512(low + j, _mm512_add_epi64(_mm512_loadu_si512(low + j), _mm512_mask_mul_epu32(av, 0xFF, av, lv)));
+                    _mm512_storeu_si512(high + j, _mm512_add_epi64(_mm512_loadu_si512(high + j), _mm512_mask_mul_epu32(av, 0xFF, av, hv)));
+                }
+                else
+                    _mm512_storeu_si512(low + j, _mm512_add_epi64(_mm512_loadu_si512(low + j), _mm512_mask_mul_epu32(av, 0xFF, av, bv)));
+            }
+#elif defined(__AVX2__)
+            const __m256i av = _mm256_set1_epi64x(static_cast<long long>(a));
+            const __m256i lowMask = _mm256_set1_epi64x(0xFFFF);
+            for (; j + 4 <= n; j += 4)
+            {
+                const __m256i bv = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j)));
+                __m256i* lowPtr = reinterpret_cast<__m256i*>(low + j);
+                if (high)
+                {
+                    __m256i* highPtr = reinterpret_cast<__m256i*>(high + j);
+                    _mm256_storeu_si256(lowPtr, _mm256_add_epi64(_mm256_loadu_si256(lowPtr), _mm256_mul_epu32(av, _mm256_and_si256(bv, lowMask))));
+                    _mm256_storeu_si256(highPtr, _mm256_add_epi64(_mm256_loadu_si256(highPtr), _mm256_mul_epu32(av, _mm256_srli_epi64(bv, 16))));
+                }
+                else
+                    _mm256_storeu_si256(lowPtr, _mm256_add_epi64(_mm256_loadu_si256(lowPtr), _mm256_mul_epu32(av, bv)));
+            }
+#endif
+            for (; j < n; ++j)
+            {
+                if (high)
+                {
+                    low[j] += a * (b[j] & 0xFFFF);
+                    high[j] += a * (b[j] >> 16);
+                }
+                else
+                    low[j] += a * b[j];
+            }
+        }
+
+        /**
+         * @brief C = A * B mod p on dense row-major reduced integers, with 64-bit lazy sums.
+         *
+         * Blocks of MB rows x NB columns of C are accumulated in 64 bits while
+         * the matching KB x NB block of B stays in cache; accumulators are
+         * reduced only when another KB products could overflow them.
+         *
+         * Above about 2^28 only a few full products fit in 64 bits, and the
+         * reductions would dominate. B is then split into 16-bit halves summed
+         * separately, which costs a second multiply-add but lets 2^16 terms
+         * accumulate before reducing; the halves are recombined at the end.
+         */
+        inline void gemmModInteger(size_t M, size_t N, size_t K, const uint32_t* a, const uint32_t* b,
+                                   uint32_t* c, const Modulus& modulus)
+        {
+            constexpr size_t MB = 64, NB = 256, KB = 256;
+            const uint64_t p = modulus.value();
+            const bool split = modulus.lazyTerms() < KB;
+            const uint64_t terms = split ? (std::numeric_limits<uint64_t>::max() - p) / ((p - 1) * 0xFFFF)
+                                         : modulus.lazyTerms();
+            const size_t step = static_cast<size_t>(std::min<uint64_t>(terms, KB));
+            const size_t rowBlocks = (M + MB - 1) / MB;
+
+            auto rowBlockRange = [&](size_t firstBlock, size_t lastBlock)
+            {
+                thread_local std::vector<uint64_t> acc, accHigh;
+                acc.resize(MB * NB);
+                accHigh.resize(split ? MB * NB : 0);
+                for (size_t ib = firstBlock; ib < lastBlock; ++ib)
+                {
+                    const size_t i0 = ib * MB, mb = std::min(MB, M - i0);
+                    for (size_t j0 = 0; j0 < N; j0 += NB)
+                    {
+                        const size_t nb = std::min(NB, N - j0);
+                        std::fill(acc.begin(), acc.end(), uint64_t{0});
+                        std::fill(accHigh.begin(), accHigh.end(), uint64_t{0});
+                        uint64_t pending = 0;
+                        for (size_t k0 = 0; k0 < K; k0 += step)
+                        {
+                            const size_t kb = std::min(step, K - k0);
+                            if (pending + kb > terms)
+                            {
+                                for (size_t e = 0; e < mb * NB; ++e)
+                                    acc[e] = modulus.reduce(acc[e]);
+                                for (size_t e = 0; e < accHigh.size(); ++e)
+                                    accHigh[e] = modulus.reduce(accHigh[e]);
+                                pending = 0;
+                            }
+                            for (size_t i = 0; i < mb; ++i)
+                            {
+                                uint64_t* accRow = acc.data() + (i * NB);
+                                const uint32_t* aRow = a + ((i0 + i) * K);
+                                uint64_t* highRow = split ? accHigh.data() + (i * NB) : nullptr;
+                                for (size_t k = k0; k < k0 + kb; ++k)
+                                    mulAddWide(accRow, highRow, aRow[k], b + (k * N) + j0, nb);
+                            }
+                            pending += kb;
+                        }
+                        for (size_t i = 0; i < mb; ++i)
+                            for (size_t j = 0; j < nb; ++j)
+                            {
+                                uint64_t sum = acc[(i * NB) + j];
+                                if (split)
+                                    sum = (uint64_t{modulus.reduce(accHigh[(i * NB) + j])} << 16) + modulus.reduce(sum);
+                                c[((i0 + i) * N) + j0 + j] = modulus.reduce(sum);
+                            }
+                    }
+                }
+            };
+            if (M * N * K >= config::parallelGemmThreshold)
+                parallelFor(rowBlocks, 1, rowBlockRange);
+            else
+                rowBlockRange(0, rowBlocks);
+        }
+    }
+
+    /**
+     * @brief Matrix product modulo p without intermediate overflow.
+     *
+     * operator* on Tensor<uint32_t> wraps at 2^32 and would have to be
+     * reduced after every product. Here elements are reduced first and sums
+     * are reduced lazily: moduli with at least config::modularDoubleTerms
+     * exact double terms (p up to about 2^23) run on the vectorized packed
+     * double GEMM, exact below 2^53; larger ones on a blocked 64-bit kernel
+     * with Barrett reduction.
+     *
+     * @tparam Layout Storage layout of the operands and result.
+     * @param a Left operand.
+     * @param b Right operand.
+     * @param modulus Modulus p.
+     * @return a * b mod p, every element in [0, p).
+     * @throws std::runtime_error if dimensions are incompatible.
+     */
+    template<typename Layout>
+    Tensor<uint32_t, Layout> multiplyMod(const Tensor<uint32_t, Layout>& a, const Tensor<uint32_t, Layout>& b,
+                                         const Modulus& modulus)
+    {
+        if (a.colCount() != b.rowCount())
+            TENSOR_THROW(std::runtime_error, "Matrix dimensions incompatible for multiplication");
+
+        const size_t M = a.rowCount(), N = b.colCount(), K = a.colCount();
+        std::vector<uint32_t> product(M * N);
+        if (modulus.exactTerms() >= config::modularDoubleTerms)
+            detail::gemmModDouble(M, N, K, detail::reducedRowMajor<double>(a, modulus).data(),
+                                  detail::reducedRowMajor<double>(b, modulus).data(), product.data(), modulus);
+        else
+            detail::gemmModInteger(M, N, K, detail::reducedRowMajor<uint32_t>(a, modulus).data(),
+                                   detail::reducedRowMajor<uint32_t>(b, modulus).data(), product.data(), modulus);
+
+        Tensor<uint32_t, RowMajor> result(M, N, std::move(product));
+        if constexpr (std::is_same<Layout, RowMajor>::value)
+            return result;
+        else
+            return result.template toLayout<Layout>();
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * @file PackedTensor.hpp
+ * @brief Right-hand matrix stored pre-packed for repeated products.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    /**
+     * @brief A matrix kept in the GEMM kernel's panel layout, for use as B in A * B.
+     *
+     * operator* repacks B into NR-column panels on every call. When B is
+     * constant (e.g. model weights) packing it once here removes that pass
+     * and its cache-hostile strided reads from every later product.
+     *
+     * @tparam T Numeric type.
+     */
+    template<typename T>
+    class PackedTensor
+    {
+    private:
+        size_t rows, cols;             ///< Shape of the packed matrix.
+        std::vector<T> panels;         ///< Panels in detail::packWhole() order.
+
+    public:
+        /**
+         * @brief Packs a tensor.
+         *
+         * @tparam Layout Layout of the source; Blocked sources are converted first.
+         * @param source The matrix to use as right-hand operand.
+         */
+        template<typename Layout>
+        explicit PackedTensor(const Tensor<T, Layout>& source)
+            : rows(source.rows), cols(source.cols), panels(detail::packedSize<T>(source.rows, source.cols))
+        {
+            if constexpr (std::is_same<Layout, RowMajor>::value)
+                detail::packWhole(rows, cols, source.values.data(), source.ld, size_t{1}, panels.data());
+            else if constexpr (std::is_same<Layout, ColMajor>::value)
+                detail::packWhole(rows, cols, source.values.data(), size_t{1}, source.ld, panels.data());
+            else
+            {
+                const Tensor<T, RowMajor> rowMajor = source.template toLayout<RowMajor>();
+                detail::packWhole(rows, cols, rowMajor.values.data(), rowMajor.ld, size_t{1}, panels.data());
+            }
+        }
+
+        /**
+         * @brief Returns the number of rows.
+         *
+         * @return Number of rows.
+         */
+        constexpr size_t rowCount() const { return rows; }
+
+        /**
+         * @brief Returns the number of columns.
+         *
+         * @return Number of columns.
+         */
+        constexpr size_t colCount() const { return cols; }
+
+        /**
+         * @brief Computes lhs * (this matrix) straight from the packed panels.
+         *
+         * @param lhs Left operand.
+         * @return Product tensor.
+         * @throws std::runtime_error if dimensions are incompatible.
+         */
+        Tensor<T, RowMajor> multiplyLeft(const Tensor<T, RowMajor>& lhs) const
+        {
+            if(lhs.cols != rows)
+                TENSOR_THROW(std::runtime_error, "Matrix dimensions incompatible for multiplication");
+
+            constexpr size_t NR = detail::GemmBlocking<T>::NR;
+            const size_t paddedCols = detail::packedSize<T>(1, cols);
+            Tensor<T, RowMajor> result(lhs.rows, cols);
+            detail::gemmPacked(lhs.rows, cols, rows, detail::Strided<T>{lhs.values.data(), lhs.ld, 1},
+                               [&](size_t pc, size_t jc, size_t kc, size_t /*nc*/)
+                               {
+                                   return panels.data() + (pc * paddedCols) + ((jc / NR) * kc * NR);
+                               },
+                               result.values.data(), result.ld);
+            return result;
+        }
+    };
+
+    /**
+     * @brief Matrix multiplication with a pre-packed right-hand side.
+     *
+     * @tparam T Numeric type.
+     * @param lhs Left operand.
+     * @param rhs Packed right operand.
+     * @return Product tensor.
+     * @throws std::runtime_error if dimensions are incompatible.
+     */
+    template<typename T>
+    Tensor<T, RowMajor> operator*(const Tensor<T, RowMajor>& lhs, const PackedTensor<T>& rhs)
+    {
+        return rhs.multiplyLeft(lhs);
+    }
+}
@@ -0,0 +1,359 @@
+/**
+ * @file Parallel.hpp
+ * @brief Minimal thread pool and parallel loops used by Tensor kernels.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Tensor
+{
+    namespace config
+    {
+        /**
+         * @brief Number of threads used by parallel kernels (0 = hardware concurrency).
+         *
+         * Read when the pool is first used; later changes only affect how many
+         * chunks a loop is split into, never the pool size.
+         */
+        inline size_t threadCount = 0;
+
+        /**
+         * @brief Element count below which element-wise kernels stay single-threaded.
+         *
+         * Waking workers costs a few microseconds, which only pays off once the
+         * operation streams several megabytes.
+         */
+        inline size_t parallelThreshold = size_t{1} << 20;
+
+        /**
+         * @brief Makes reductions and matrix products bit-reproducible for any thread count.
+         *
+         * When false, parallel reductions add per-thread partials in completion
+         * order and products split K into one slice per thread, so the last
+         * bits of a result can change with threadCount or between runs. When
+         * true, reductions sum fixed blocks of reductionBlock elements and add
+         * the partials in a fixed pairwise tree, and products split K only by
+         * shape, into slices of deterministicKSlice, and never run on generated
+         * kernels (see Gemm.hpp).
+         *
+         * Cost versus the fast mode: reductions keep the same throughput (one
+         * partial per block, under 0.01% extra work); a product that qualifies
+         * for a K-split uses ceil(K / deterministicKSlice) slices instead of one
+         * per thread, costing one extra M x N accumulation per slice and load
+         * imbalance when the slice count doesn't divide evenly across threads.
+         * Results stay dependent on the instruction set (vector width), so they
+         * match across thread counts, not across machines.
+         */
+        inline bool deterministic = false;
+
+        /// @brief Elements per leaf of the deterministic reduction tree.
+        inline size_t reductionBlock = size_t{1} << 14;
+    }
+
+    namespace detail
+    {
+        /// @brief Size of a cache line; chunk boundaries are aligned to it to avoid false sharing.
+        inline constexpr size_t cacheLine = 64;
+
+        /**
+         * @brief Fixed-size pool of worker threads fed from a single task queue.
+         */
+        class ThreadPool
+        {
+        private:
+            std::vector<std::thread> workers;
+            std::queue<std::function<void()>> tasks;
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool stopping = false;
+
+            static bool& insideWorker()
+            {
+                thread_local bool flag = false;
+                return flag;
+            }
+
+        public:
+            /**
+             * @brief Starts the worker threads.
+             *
+             * @param threads Number of workers.
+             */
+            explicit ThreadPool(size_t threads)
+            {
+                for (size_t t = 0; t < threads; ++t)
+                {
+                    workers.emplace_back([this]
+                    {
+                        insideWorker() = true;
+                        for (;;)
+                        {
+                            std::function<void()> task;
+                            {
+                                std::unique_lock<std::mutex> lock(mutex);
+                                wake.wait(lock, [this]{ return stopping || !tasks.empty(); });
+                                if (stopping && tasks.empty())
+                                    return;
+                                task = std::move(tasks.front());
+                                tasks.pop();
+                            }
+                            task();
+                        }
+                    });
+                }
+            }
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            /// @brief Drains the queue and joins the workers.
+            ~ThreadPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_all();
+                for (auto& worker : workers)
+                    worker.join();
+            }
+
+            /// @brief Number of worker threads.
+            size_t size() const { return workers.size(); }
+
+            /// @brief true when called from one of the pool's workers.
+            static bool onWorker() { return insideWorker(); }
+
+            /**
+             * @brief Queues a task for execution on a worker.
+             *
+             * @param task Callable to run.
+             */
+            void submit(std::function<void()> task)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    tasks.push(std::move(task));
+                }
+                wake.notify_one();
+            }
+        };
+
+        /// @brief Number of threads parallel loops may use.
+        inline size_t threadCount()
+        {
+            if (config::threadCount != 0)
+                return config::threadCount;
+            return std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        /**
+         * @brief Process-wide pool, created on first use with threadCount() - 1 workers.
+         *
+         * The calling thread always takes a share of the work, hence the - 1.
+         */
+        inline ThreadPool& pool()
+        {
+            static ThreadPool instance(threadCount() - 1);
+            return instance;
+        }
+
+        /**
+         * @brief Runs chunk() and returns what it threw, or a null pointer.
+         *
+         * Without exceptions enabled it only runs chunk().
+         */
+        template<typename Chunk>
+        std::exception_ptr captureException(Chunk&& chunk)
+        {
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+            try
+            {
+                chunk();
+            }
+            catch (...)
+            {
+                return std::current_exception();
+            }
+#else
+            chunk();
+#endif
+            return nullptr;
+        }
+
+        /**
+         * @brief Calls body(first, last) on disjoint chunks covering [0, count).
+         *
+         * Chunk boundaries are multiples of grain. Runs serially when only one
+         * chunk results or when already inside a pool worker (nested loops
+         * would otherwise wait on themselves).
+         *
+         * If a chunk throws, the other chunks still run to completion and the
+         * first exception caught is rethrown on the calling thread once every
+         * worker is done with body.
+         *
+         * @param count Number of iterations.
+         * @param grain Minimum iterations per chunk.
+         * @param body Callable taking (first, last).
+         */
+        template<typename Body>
+        void parallelFor(size_t count, size_t grain, Body&& body)
+        {
+            grain = std::max<size_t>(grain, 1);
+            const size_t threads = std::min(threadCount(), pool().size() + 1);
+            const size_t maxChunks = (count + grain - 1) / grain;
+            const size_t chunks = std::min(threads, maxChunks);
+            if (chunks <= 1 || ThreadPool::onWorker())
+            {
+                if (count > 0)
+                    body(size_t{0}, count);
+                return;
+            }
+
+            // Chunk sizes rounded up to whole grains, so only the last one is ragged.
+            const size_t perChunk = ((maxChunks + chunks - 1) / chunks) * grain;
+
+            std::mutex doneMutex;
+            std::condition_variable doneSignal;
+            size_t pending = 0;
+            std::exception_ptr error;
+
+            for (size_t first = perChunk; first < count; first += perChunk)
+            {
+                const size_t last = std::min(count, first + perChunk);
+                {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    ++pending;
+                }
+                pool().submit([&, first, last]
+                {
+                    std::exception_ptr thrown = captureException([&]{ body(first, last); });
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    if (thrown && !error)
+                        error = std::move(thrown);
+                    if (--pending == 0)
+                        doneSignal.notify_one();
+                });
+            }
+
+            std::exception_ptr thrown = captureException([&]{ body(size_t{0}, std::min(count, perChunk)); });
+
+            // Workers reference this frame, so wait for them even when the inline chunk failed.
+            std::unique_lock<std::mutex> lock(doneMutex);
+            if (thrown && !error)
+                error = std::move(thrown);
+            doneSignal.wait(lock, [&]{ return pending == 0; });
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+            if (error)
+                std::rethrow_exception(error);
+#endif
+        }
+
+        /**
+         * @brief Adds partials[0, n) pairwise in a fixed tree order and returns the total.
+         *
+         * The order depends only on n, never on which thread produced what.
+         */
+        template<typename T>
+        T treeSum(std::vector<T>& partials)
+        {
+            const size_t n = partials.size();
+            if (n == 0)
+                return T{};
+            for (size_t width = 1; width < n; width *= 2)
+                for (size_t i = 0; i + width < n; i += 2 * width)
+                    partials[i] += partials[i + width];
+            return partials[0];
+        }
+
+        /**
+         * @brief Sums leaf(first, last) over a partition of [0, count).
+         *
+         * In config::deterministic mode the partition is fixed blocks of grain
+         * items, combined by treeSum(), so serial and parallel runs with any
+         * thread count agree bit for bit. Otherwise the range is split like
+         * parallelFor() and the partials are added as threads finish.
+         *
+         * @param count Number of items.
+         * @param grain Items per block (deterministic) or minimum items per chunk.
+         * @param parallel Whether to use the pool; callers pass false below their size threshold.
+         * @param leaf Callable taking (first, last) and returning the partial sum.
+         */
+        template<typename T, typename Leaf>
+        T parallelReduce(size_t count, size_t grain, bool parallel, Leaf&& leaf)
+        {
+            grain = std::max<size_t>(grain, 1);
+            if (config::deterministic)
+            {
+                std::vector<T> partials((count + grain - 1) / grain);
+                auto run = [&](size_t firstBlock, size_t lastBlock)
+                {
+                    for (size_t block = firstBlock; block < lastBlock; ++block)
+                        partials[block] = leaf(block * grain, std::min(count, (block + 1) * grain));
+                };
+                if (parallel)
+                    parallelFor(partials.size(), 1, run);
+                else
+                    run(0, partials.size());
+                return treeSum(partials);
+            }
+
+            if (!parallel)
+                return count > 0 ? leaf(size_t{0}, count) : T{};
+            T total{};
+            std::mutex totalMutex;
+            parallelFor(count, grain, [&](size_t first, size_t last)
+            {
+                const T partial = leaf(first, last);
+                std::lock_guard<std::mutex> lock(totalMutex);
+                total += partial;
+            });
+            return total;
+        }
+
+        /**
+         * @brief Splits a contiguous array into cache-line-aligned chunks processed in parallel.
+         *
+         * Interior chunk boundaries fall on cache-line boundaries of the actual
+         * addresses, so no two threads ever write to the same line.
+         *
+         * @param base Start of the array (used for alignment only).
+         * @param count Number of elements.
+         * @param body Callable taking (offset, length).
+         */
+        template<typename T, typename Body>
+        void parallelChunks(const T* base, size_t count, Body&& body)
+        {
+            constexpr size_t lineElems = std::max<size_t>(1, cacheLine / sizeof(T));
+            const size_t misalign = (reinterpret_cast<std::uintptr_t>(base) % cacheLine) / sizeof(T);
+            const size_t head = std::min(count, (lineElems - misalign) % lineElems);
+
+            // Work in units of whole cache lines after the unaligned head.
+            const size_t lines = (count - head + lineElems - 1) / lineElems;
+            const size_t grain = std::max<size_t>(1, (size_t{64} << 10) / cacheLine);   // >= 64 KiB per chunk
+            parallelFor(lines, grain, [&](size_t firstLine, size_t lastLine)
+            {
+                size_t first = head + (firstLine * lineElems);
+                const size_t last = std::min(count, head + (lastLine * lineElems));
+                if (firstLine == 0)
+                    first = 0;
+                body(first, last - first);
+            });
+            if (lines == 0 && count > 0)
+                body(size_t{0}, count);
+        }
+    }
+}
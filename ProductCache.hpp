@@ -0,0 +1,212 @@
+/**
+ * @file ProductCache.hpp
+ * @brief LRU cache of matrix products for repeated multiplications.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    /**
+     * @brief How ProductCache recognizes operands it has seen before.
+     */
+    enum class CacheKey
+    {
+        Version,    ///< Tensor::version(): O(1), hits only for the same contents lineage (copies included).
+        Content     ///< Tensor::contentHash(): O(n) per lookup, hits for any equal contents.
+    };
+
+    /**
+     * @brief Counters reported by ProductCache::stats().
+     */
+    struct CacheStats
+    {
+        uint64_t hits = 0;          ///< Products served from the cache.
+        uint64_t misses = 0;        ///< Products computed.
+        uint64_t evictions = 0;     ///< Entries dropped to stay within the budget.
+        size_t entries = 0;         ///< Products currently cached.
+        size_t bytes = 0;           ///< Element storage currently held.
+    };
+
+    /**
+     * @brief Memoizes A * B, evicting least recently used products beyond a memory budget.
+     *
+     * Typical use is a constant weight matrix multiplied against recurring
+     * inputs. Results are shared, immutable tensors, so a hit costs a lookup
+     * and no copy. Safe to use from several threads as long as no thread
+     * writes an operand during a call (keys come from Tensor::version() or
+     * Tensor::contentHash(), read without the cache's lock); a product
+     * missing concurrently may be computed twice.
+     *
+     * With CacheKey::Content two 64-bit hashes identify the operands, so a
+     * (vanishingly unlikely) collision would return a wrong product.
+     *
+     * @tparam T Numeric type.
+     * @tparam Layout Storage layout of the operands.
+     */
+    template<typename T, typename Layout = RowMajor>
+    class ProductCache
+    {
+    public:
+        using Product = std::shared_ptr<const Tensor<T, Layout>>;
+
+    private:
+        struct Key
+        {
+            uint64_t left, right;
+            size_t leftRows, inner, rightCols;
+
+            bool operator==(const Key& other) const
+            {
+                return left == other.left && right == other.right && leftRows == other.leftRows
+                    && inner == other.inner && rightCols == other.rightCols;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                return static_cast<size_t>(detail::ContentHasher::mixWord(key.left, key.right)
+                                           ^ detail::ContentHasher::mixWord(key.leftRows ^ (key.rightCols << 32), key.inner));
+            }
+        };
+
+        struct Entry
+        {
+            Key key;
+            Product product;
+            size_t bytes;
+        };
+
+        size_t budget;
+        CacheKey mode;
+        std::list<Entry> lru;   ///< Most recently used first.
+        std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> index;
+        CacheStats counters;
+        mutable std::mutex mutex;
+
+        Key makeKey(const Tensor<T, Layout>& a, const Tensor<T, Layout>& b) const
+        {
+            if (mode == CacheKey::Content)
+                return {a.contentHash(), b.contentHash(), a.rowCount(), a.colCount(), b.colCount()};
+            return {a.version(), b.version(), a.rowCount(), a.colCount(), b.colCount()};
+        }
+
+        void evictTo(size_t limit)
+        {
+            while (counters.bytes > limit && !lru.empty())
+            {
+                counters.bytes -= lru.back().bytes;
+                index.erase(lru.back().key);
+                lru.pop_back();
+                ++counters.evictions;
+            }
+            counters.entries = lru.size();
+        }
+
+    public:
+        /**
+         * @brief Creates an empty cache.
+         *
+         * @param budgetBytes Maximum element storage held by cached products.
+         * @param mode How operands are identified.
+         */
+        explicit ProductCache(size_t budgetBytes, CacheKey mode = CacheKey::Version)
+            : budget(budgetBytes), mode(mode)
+        {
+        }
+
+        ProductCache(const ProductCache&) = delete;
+        ProductCache& operator=(const ProductCache&) = delete;
+
+        /**
+         * @brief Returns A * B, computing it only if not cached.
+         *
+         * Products larger than the whole budget are computed but not kept.
+         *
+         * @param a Left operand.
+         * @param b Right operand.
+         * @return Shared, immutable product.
+         * @throws std::runtime_error if dimensions are incompatible.
+         */
+        Product multiply(const Tensor<T, Layout>& a, const Tensor<T, Layout>& b)
+        {
+            const Key key = makeKey(a, b);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto found = index.find(key);
+                if (found != index.end())
+                {
+                    lru.splice(lru.begin(), lru, found->second);
+                    ++counters.hits;
+                    return found->second->product;
+                }
+                ++counters.misses;
+            }
+
+            Product product = std::make_shared<const Tensor<T, Layout>>(a * b);
+            const size_t bytes = product->rowCount() * product->colCount() * sizeof(T);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (bytes <= budget && index.find(key) == index.end())
+            {
+                lru.push_front({key, product, bytes});
+                index.emplace(key, lru.begin());
+                counters.bytes += bytes;
+                evictTo(budget);
+            }
+            return product;
+        }
+
+        /**
+         * @brief Changes the memory budget, evicting entries if needed.
+         *
+         * @param budgetBytes New maximum element storage.
+         */
+        void setBudget(size_t budgetBytes)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            budget = budgetBytes;
+            evictTo(budget);
+        }
+
+        /// @brief Drops all cached products (counters are kept).
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            lru.clear();
+            index.clear();
+            counters.bytes = 0;
+            counters.entries = 0;
+        }
+
+        /// @brief Resets the hit, miss and eviction counters.
+        void resetStats()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            counters.hits = counters.misses = counters.evictions = 0;
+        }
+
+        /**
+         * @brief Returns a snapshot of the counters.
+         *
+         * @return Hit/miss/eviction counts and current occupancy.
+         */
+        CacheStats stats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return counters;
+        }
+    };
+}
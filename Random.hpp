@@ -0,0 +1,365 @@
+/**
+ * @file Random.hpp
+ * @brief Parallel, reproducible random fills of Tensor with a counter-based generator.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    /**
+     * @brief Uniform distribution on [low, high).
+     */
+    struct Uniform
+    {
+        double low = 0;
+        double high = 1;
+    };
+
+    /**
+     * @brief Normal distribution N(mean, stddev^2), sampled by Box-Muller.
+     */
+    struct Normal
+    {
+        double mean = 0;
+        double stddev = 1;
+    };
+
+    /**
+     * @brief Bernoulli distribution: 1 with probability p, otherwise 0.
+     */
+    struct Bernoulli
+    {
+        double p = 0.5;
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Philox4x32-10 (Salmon et al., 2011): 128-bit counter, 64-bit key, four words per block.
+         *
+         * Block b of a stream is a pure function of (seed, stream, b), so any
+         * range of the sequence can be produced independently, in any order and
+         * on any thread. Blocks are computed 16 (AVX-512) or 8 (AVX2) at a time,
+         * one per lane, with the same output as the scalar rounds.
+         */
+        class Philox
+        {
+        private:
+            static constexpr uint32_t mul0 = 0xD2511F53u;
+            static constexpr uint32_t mul1 = 0xCD9E8D57u;
+            static constexpr uint32_t weyl0 = 0x9E3779B9u;
+            static constexpr uint32_t weyl1 = 0xBB67AE85u;
+
+            uint32_t key[2];
+            uint32_t streamWords[2];
+
+#if defined(__AVX512F__)
+            static void mulHiLo(__m512i a, __m512i m, __m512i& hi, __m512i& lo)
+            {
+                const __m512i even = _mm512_mask_mul_epu32(a, 0xFF, a, m);
+                const __m512i odd = _mm512_mask_mul_epu32(a, 0xFF, _mm512_mask_srli_epi64(a, 0xFF, a, 32), m);
+                hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_mask_srli_epi64(even, 0xFF, even, 32), odd);
+                lo = _mm512_mullo_epi32(a, m);
+            }
+#endif
+#if defined(__AVX2__)
+            static void mulHiLo(__m256i a, __m256i m, __m256i& hi, __m256i& lo)
+            {
+                const __m256i even = _mm256_mul_epu32(a, m);
+                const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+                hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+                lo = _mm256_mullo_epi32(a, m);
+            }
+#endif
+
+            /// @brief Runs the vector rounds on `lanes` consecutive blocks from first and interleaves them into out.
+            template<typename Reg, size_t lanes, typename Set1, typename Xor, typename Add, typename Store>
+            void blocksVector(uint64_t first, uint32_t* out, Set1 set1, Xor bitXor, Add add, Store store) const
+            {
+                alignas(64) uint32_t laneIndex[lanes];
+                for (size_t l = 0; l < lanes; ++l)
+                    laneIndex[l] = static_cast<uint32_t>(first) + static_cast<uint32_t>(l);
+
+                Reg c0, c1 = set1(static_cast<uint32_t>(first >> 32));
+                Reg c2 = set1(streamWords[0]), c3 = set1(streamWords[1]);
+                std::memcpy(&c0, laneIndex, sizeof c0);
+                Reg k0 = set1(key[0]), k1 = set1(key[1]);
+                const Reg m0 = set1(mul0), m1 = set1(mul1);
+                const Reg w0 = set1(weyl0), w1 = set1(weyl1);
+                for (int round = 0; round < 10; ++round)
+                {
+                    Reg hi0, lo0, hi1, lo1;
+                    mulHiLo(c0, m0, hi0, lo0);
+                    mulHiLo(c2, m1, hi1, lo1);
+                    c0 = bitXor(bitXor(hi1, c1), k0);
+                    c1 = lo1;
+                    c2 = bitXor(bitXor(hi0, c3), k1);
+                    c3 = lo0;
+                    k0 = add(k0, w0);
+                    k1 = add(k1, w1);
+                }
+
+                alignas(64) uint32_t words[4][lanes];
+                store(words[0], c0);
+                store(words[1], c1);
+                store(words[2], c2);
+                store(words[3], c3);
+                for (size_t l = 0; l < lanes; ++l)
+                    for (size_t w = 0; w < 4; ++w)
+                        out[(l * 4) + w] = words[w][l];
+            }
+
+        public:
+            /**
+             * @brief Selects the sequence.
+             *
+             * @param seed Key; different seeds give independent sequences.
+             * @param stream Upper half of the counter, for independent substreams under one seed.
+             */
+            Philox(uint64_t seed, uint64_t stream)
+                : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+                  streamWords{static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)}
+            {
+            }
+
+            /**
+             * @brief Computes the four words of block b.
+             */
+            void block(uint64_t b, uint32_t out[4]) const
+            {
+                uint32_t c0 = static_cast<uint32_t>(b), c1 = static_cast<uint32_t>(b >> 32);
+                uint32_t c2 = streamWords[0], c3 = streamWords[1];
+                uint32_t k0 = key[0], k1 = key[1];
+                for (int round = 0; round < 10; ++round)
+                {
+                    const uint64_t p0 = static_cast<uint64_t>(mul0) * c0;
+                    const uint64_t p1 = static_cast<uint64_t>(mul1) * c2;
+                    c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+                    c1 = static_cast<uint32_t>(p1);
+                    c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+                    c3 = static_cast<uint32_t>(p0);
+                    k0 += weyl0;
+                    k1 += weyl1;
+                }
+                out[0] = c0;
+                out[1] = c1;
+                out[2] = c2;
+                out[3] = c3;
+            }
+
+            /**
+             * @brief Writes the words of blocks [first, first + count) to out, four per block.
+             */
+            void blocks(uint64_t first, size_t count, uint32_t* out) const
+            {
+                size_t b = 0;
+#if defined(__AVX512F__)
+                // Lanes share the upper counter word, so a group must not carry across it.
+                for (; b + 16 <= count && static_cast<uint32_t>(first + b) <= 0xFFFFFFFFu - 15; b += 16)
+                    blocksVector<__m512i, 16>(first + b, out + (b * 4),
+                        [](uint32_t v) { return _mm512_set1_epi32(static_cast<int>(v)); },
+                        [](__m512i x, __m512i y) { return _mm512_xor_si512(x, y); },
+                        [](__m512i x, __m512i y) { return _mm512_add_epi32(x, y); },
+                        [](uint32_t* p, __m512i v) { _mm512_store_si512(p, v); });
+#elif defined(__AVX2__)
+                for (; b + 8 <= count && static_cast<uint32_t>(first + b) <= 0xFFFFFFFFu - 7; b += 8)
+                    blocksVector<__m256i, 8>(first + b, out + (b * 4),
+                        [](uint32_t v) { return _mm256_set1_epi32(static_cast<int>(v)); },
+                        [](__m256i x, __m256i y) { return _mm256_xor_si256(x, y); },
+                        [](__m256i x, __m256i y) { return _mm256_add_epi32(x, y); },
+                        [](uint32_t* p, __m256i v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); });
+#endif
+                for (; b < count; ++b)
+                    block(first + b, out + (b * 4));
+            }
+        };
+
+        /// @brief [0, 1) from the top 24 bits of a word.
+        inline float unitFloat(uint32_t word) { return static_cast<float>(word >> 8) * 0x1.0p-24f; }
+
+        /// @brief [0, 1) from the top 53 bits of two words.
+        inline double unitDouble(uint32_t lo, uint32_t hi)
+        {
+            return static_cast<double>(((static_cast<uint64_t>(hi) << 32) | lo) >> 11) * 0x1.0p-53;
+        }
+
+        /**
+         * @brief Maps generator words to samples of a distribution.
+         *
+         * Samples come in groups of `group` elements consuming `words` words;
+         * element e of the tensor storage is element e % group of group e / group.
+         */
+        template<typename T, typename Distribution>
+        struct Sampler;
+
+        template<typename T>
+        struct Sampler<T, Uniform>
+        {
+            static_assert(std::is_floating_point<T>::value, "Uniform fills require a floating point type");
+            static constexpr size_t group = 1;
+            static constexpr size_t words = sizeof(T) > sizeof(float) ? 2 : 1;
+            T low, width;
+
+            explicit Sampler(const Uniform& d) : low(static_cast<T>(d.low)), width(static_cast<T>(d.high - d.low)) {}
+
+            void operator()(const uint32_t* w, T* out) const
+            {
+                if constexpr (words == 2)
+                    out[0] = low + (width * static_cast<T>(unitDouble(w[0], w[1])));
+                else
+                    out[0] = low + (width * static_cast<T>(unitFloat(w[0])));
+            }
+        };
+
+        template<typename T>
+        struct Sampler<T, Normal>
+        {
+            static_assert(std::is_floating_point<T>::value, "Normal fills require a floating point type");
+            static constexpr size_t group = 2;
+            static constexpr size_t words = sizeof(T) > sizeof(float) ? 4 : 2;
+            T mean, stddev;
+
+            explicit Sampler(const Normal& d) : mean(static_cast<T>(d.mean)), stddev(static_cast<T>(d.stddev)) {}
+
+            void operator()(const uint32_t* w, T* out) const
+            {
+                using U = std::conditional_t<words == 4, double, float>;
+                U u1, u2;
+                if constexpr (words == 4)
+                {
+                    u1 = 1.0 - unitDouble(w[0], w[1]);   // (0, 1], keeps log finite
+                    u2 = unitDouble(w[2], w[3]);
+                }
+                else
+                {
+                    u1 = 1.0f - unitFloat(w[0]);
+                    u2 = unitFloat(w[1]);
+                }
+                const U radius = std::sqrt(U{-2} * std::log(u1));
+                const U angle = static_cast<U>(6.283185307179586476925) * u2;
+                out[0] = mean + (stddev * static_cast<T>(radius * std::cos(angle)));
+                out[1] = mean + (stddev * static_cast<T>(radius * std::sin(angle)));
+            }
+        };
+
+        template<typename T>
+        struct Sampler<T, Bernoulli>
+        {
+            static constexpr size_t group = 1;
+            static constexpr size_t words = 1;
+            uint64_t threshold;   ///< Words below it are successes; 2^32 means always.
+
+            explicit Sampler(const Bernoulli& d)
+                : threshold(d.p >= 1 ? uint64_t{1} << 32 : d.p <= 0 ? 0 : static_cast<uint64_t>(std::ldexp(d.p, 32)))
+            {
+            }
+
+            void operator()(const uint32_t* w, T* out) const
+            {
+                out[0] = w[0] < threshold ? T{1} : T{0};
+            }
+        };
+
+        /**
+         * @brief Writes samples for storage elements [first, first + count) to out.
+         *
+         * Works through the range in slices small enough for the word buffer to
+         * stay in L1; partial groups at the ends are generated whole and clipped.
+         */
+        template<typename T, typename S>
+        void sampleRange(const Philox& rng, const S& sampler, size_t first, size_t count, T* out)
+        {
+            constexpr size_t G = S::group, W = S::words;
+            constexpr size_t sliceGroups = 512;
+            alignas(64) uint32_t words[(sliceGroups * W) + 8];
+
+            size_t e = first;
+            const size_t end = first + count;
+            while (e < end)
+            {
+                const size_t g0 = e / G;
+                const size_t g1 = std::min(g0 + sliceGroups, (end + G - 1) / G);
+                const uint64_t w0 = static_cast<uint64_t>(g0) * W;
+                const uint64_t b0 = w0 / 4, b1 = ((static_cast<uint64_t>(g1) * W) + 3) / 4;
+                rng.blocks(b0, static_cast<size_t>(b1 - b0), words);
+                const uint32_t* w = words + (w0 - (b0 * 4));
+
+                for (size_t g = g0; g < g1; ++g, w += W)
+                {
+                    const size_t base = g * G;
+                    if (base >= e && base + G <= end)
+                        sampler(w, out + (base - first));
+                    else
+                    {
+                        T group[G];
+                        sampler(w, group);
+                        for (size_t k = std::max(base, e); k < std::min(base + G, end); ++k)
+                            out[k - first] = group[k - base];
+                    }
+                }
+                e = std::min(end, g1 * G);
+            }
+        }
+    }
+
+    /**
+     * @brief Overwrites a tensor with samples of a distribution.
+     *
+     * Sample k of the sequence goes to storage element k, and the sequence is
+     * a pure function of (seed, stream), so the result is bit-identical for
+     * any thread count and chunking; tensors of different layouts or leading
+     * dimensions receive the same sequence in their own storage order. Large
+     * tensors are filled in parallel.
+     *
+     * @tparam Distribution Uniform, Normal or Bernoulli.
+     * @param tensor Tensor to fill.
+     * @param distribution Distribution parameters.
+     * @param seed Generator key.
+     * @param stream Independent substream under the same seed.
+     */
+    template<typename T, typename Layout, typename Distribution>
+    void fillRandom(Tensor<T, Layout>& tensor, const Distribution& distribution, uint64_t seed, uint64_t stream = 0)
+    {
+        const detail::Philox rng(seed, stream);
+        const detail::Sampler<T, Distribution> sampler(distribution);
+        T* out = detail::TensorAccess::storage(tensor);
+        detail::TensorAccess::forEachRunParallel(tensor, [&](size_t offset, size_t length)
+        {
+            detail::sampleRange(rng, sampler, offset, length, out + offset);
+        });
+    }
+
+    /**
+     * @brief Creates a tensor of samples of a distribution.
+     *
+     * @param rows Number of rows.
+     * @param cols Number of columns.
+     * @param distribution Uniform, Normal or Bernoulli parameters.
+     * @param seed Generator key.
+     * @param stream Independent substream under the same seed.
+     * @return The filled tensor (see fillRandom()).
+     */
+    template<typename T, typename Layout = RowMajor, typename Distribution>
+    Tensor<T, Layout> random(size_t rows, size_t cols, const Distribution& distribution, uint64_t seed, uint64_t stream = 0)
+    {
+        Tensor<T, Layout> result(rows, cols);
+        fillRandom(result, distribution, seed, stream);
+        return result;
+    }
+}
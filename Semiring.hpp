@@ -0,0 +1,128 @@
+/**
+ * @file Semiring.hpp
+ * @brief Semirings that generalize the (+, *) of the matrix product.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "Simd.hpp"
+
+namespace Tensor
+{
+    /**
+     * @brief The ordinary (+, *) semiring; the default of every product kernel.
+     *
+     * A semiring policy supplies:
+     *  - zero(): identity of add(), which also absorbs under mul(); products start from it,
+     *  - add() / mul(): the scalar operations, mul() commutative (ColMajor products
+     *    are computed as C^T = B^T * A^T),
+     *  - vectorized: whether vadd<V>() / vmul<V>() exist for simd::VecOps<T>,
+     *    letting the packed micro-kernel keep its register tile.
+     *
+     * @tparam T Element type.
+     */
+    template<typename T>
+    struct PlusTimes
+    {
+        static constexpr bool vectorized = detail::simd::VecOps<T>::hasMul;
+        static constexpr T zero() { return T{}; }
+        static constexpr T add(T a, T b) { return static_cast<T>(a + b); }
+        static constexpr T mul(T a, T b) { return static_cast<T>(a * b); }
+        template<typename V> static typename V::reg vadd(typename V::reg a, typename V::reg b) { return V::add(a, b); }
+        template<typename V> static typename V::reg vmul(typename V::reg a, typename V::reg b) { return V::mul(a, b); }
+    };
+
+    /**
+     * @brief Tropical (min, +) semiring: C(i, j) = min_k A(i, k) + B(k, j).
+     *
+     * Squaring a distance matrix under it relaxes every path by one edge, so
+     * repeated squaring gives all-pairs shortest paths. zero() is +infinity
+     * (the largest value for integers, where mul() saturates at it).
+     */
+    template<typename T>
+    struct MinPlus
+    {
+        static constexpr bool vectorized = std::is_floating_point_v<T> && detail::simd::VecOps<T>::available;
+        static constexpr T zero()
+        {
+            return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+        }
+        static constexpr T add(T a, T b) { return std::min(a, b); }
+        static constexpr T mul(T a, T b)
+        {
+            if constexpr (!std::numeric_limits<T>::has_infinity)
+                if (a == zero() || b == zero())
+                    return zero();
+            return static_cast<T>(a + b);
+        }
+        template<typename V> static typename V::reg vadd(typename V::reg a, typename V::reg b) { return V::min(a, b); }
+        template<typename V> static typename V::reg vmul(typename V::reg a, typename V::reg b) { return V::add(a, b); }
+    };
+
+    /**
+     * @brief Tropical (max, +) semiring: C(i, j) = max_k A(i, k) + B(k, j).
+     *
+     * Longest paths and critical-path scheduling; zero() is -infinity (the
+     * lowest value for integers, where mul() saturates at it).
+     */
+    template<typename T>
+    struct MaxPlus
+    {
+        static constexpr bool vectorized = std::is_floating_point_v<T> && detail::simd::VecOps<T>::available;
+        static constexpr T zero()
+        {
+            return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+        }
+        static constexpr T add(T a, T b) { return std::max(a, b); }
+        static constexpr T mul(T a, T b)
+        {
+            if constexpr (!std::numeric_limits<T>::has_infinity)
+                if (a == zero() || b == zero())
+                    return zero();
+            return static_cast<T>(a + b);
+        }
+        template<typename V> static typename V::reg vadd(typename V::reg a, typename V::reg b) { return V::max(a, b); }
+        template<typename V> static typename V::reg vmul(typename V::reg a, typename V::reg b) { return V::add(a, b); }
+    };
+
+    /**
+     * @brief (max, *) semiring over non-negative values: C(i, j) = max_k A(i, k) * B(k, j).
+     *
+     * The Viterbi semiring of most-probable paths; zero() is 0, so operands
+     * must not hold negative values.
+     */
+    template<typename T>
+    struct MaxTimes
+    {
+        static constexpr bool vectorized = std::is_floating_point_v<T> && detail::simd::VecOps<T>::available;
+        static constexpr T zero() { return T{}; }
+        static constexpr T add(T a, T b) { return std::max(a, b); }
+        static constexpr T mul(T a, T b) { return static_cast<T>(a * b); }
+        template<typename V> static typename V::reg vadd(typename V::reg a, typename V::reg b) { return V::max(a, b); }
+        template<typename V> static typename V::reg vmul(typename V::reg a, typename V::reg b) { return V::mul(a, b); }
+    };
+
+    /**
+     * @brief Boolean (or, and) semiring over 0/1 values: C(i, j) = 1 if some A(i, k) = B(k, j) = 1.
+     *
+     * Reachability and transitive closure. On 0/1 operands, or and and are
+     * max and min, which is how they are evaluated; other values give the
+     * (max, min) "bottleneck" product instead.
+     */
+    template<typename T>
+    struct OrAnd
+    {
+        static constexpr bool vectorized = std::is_floating_point_v<T> && detail::simd::VecOps<T>::available;
+        static constexpr T zero() { return T{}; }
+        static constexpr T add(T a, T b) { return std::max(a, b); }
+        static constexpr T mul(T a, T b) { return std::min(a, b); }
+        template<typename V> static typename V::reg vadd(typename V::reg a, typename V::reg b) { return V::max(a, b); }
+        template<typename V> static typename V::reg vmul(typename V::reg a, typename V::reg b) { return V::min(a, b); }
+    };
+}
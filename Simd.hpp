@@ -0,0 +1,679 @@
+/**
+ * @file Simd.hpp
+ * @brief Explicitly vectorized element-wise kernels used by Tensor.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace Tensor
+{
+    namespace config
+    {
+        /**
+         * @brief Output size (in bytes) above which kernels use non-temporal stores.
+         *
+         * Results larger than the last level cache would only evict the
+         * operands on their way to memory, so they bypass the cache instead.
+         * The default matches a typical desktop LLC; tune it per machine.
+         */
+        inline size_t nonTemporalBytes = size_t{32} << 20;
+    }
+
+    namespace detail
+    {
+        namespace simd
+        {
+            /**
+             * @brief Register-level operations for one element type.
+             *
+             * Specializations exist for the widest instruction set enabled at
+             * compile time (floating point ones also provide abs/min/max/allLe/hmax
+             * for the comparison kernels); the primary template marks the type as unsupported
+             * so callers fall back to scalar code.
+             */
+            template<typename T, typename = void>
+            struct VecOps
+            {
+                static constexpr bool available = false;
+                static constexpr bool hasMul = false;
+            };
+
+#if defined(__AVX512F__)
+            template<>
+            struct VecOps<float>
+            {
+                using reg = __m512;
+                static constexpr bool available = true;
+                static constexpr bool hasMul = true;
+                static constexpr size_t width = 16;
+                static constexpr size_t alignment = 64;
+                static reg loadu(const float* p) { return _mm512_loadu_ps(p); }
+                static void store(float* p, reg v) { _mm512_store_ps(p, v); }
+                static void storeu(float* p, reg v) { _mm512_storeu_ps(p, v); }
+                static void stream(float* p, reg v) { _mm512_stream_ps(p, v); }
+                static reg set1(float v) { return _mm512_set1_ps(v); }
+                static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+                static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+                static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+                static reg abs(reg a) { return _mm512_abs_ps(a); }
+                static reg min(reg a, reg b) { return _mm512_mask_min_ps(a, 0xFFFF, a, b); }
+                static reg max(reg a, reg b) { return _mm512_mask_max_ps(a, 0xFFFF, a, b); }
+                static bool allLe(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ) == 0xFFFF; }
+                static float hmax(reg a)
+                {
+                    alignas(64) float lanes[16];
+                    _mm512_store_ps(lanes, a);
+                    return *std::max_element(lanes, lanes + 16);
+                }
+            };
+
+            template<>
+            struct VecOps<double>
+            {
+                using reg = __m512d;
+                static constexpr bool available = true;
+                static constexpr bool hasMul = true;
+                static constexpr size_t width = 8;
+                static constexpr size_t alignment = 64;
+                static reg loadu(const double* p) { return _mm512_loadu_pd(p); }
+                static void store(double* p, reg v) { _mm512_store_pd(p, v); }
+                static void storeu(double* p, reg v) { _mm512_storeu_pd(p, v); }
+                static void stream(double* p, reg v) { _mm512_stream_pd(p, v); }
+                static reg set1(double v) { return _mm512_set1_pd(v); }
+                static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+                static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+                static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+                static reg abs(reg a) { return _mm512_abs_pd(a); }
+                static reg min(reg a, reg b) { return _mm512_mask_min_pd(a, 0xFF, a, b); }
+                static reg max(reg a, reg b) { return _mm512_mask_max_pd(a, 0xFF, a, b); }
+                static bool allLe(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ) == 0xFF; }
+                static double hmax(reg a)
+                {
+                    alignas(64) double lanes[8];
+                    _mm512_store_pd(lanes, a);
+                    return *std::max_element(lanes, lanes + 8);
+                }
+            };
+
+            template<typename T>
+            struct VecOps<T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) == 4>>
+            {
+                using reg = __m512i;
+                static constexpr bool available = true;
+                static constexpr bool hasMul = true;
+                static constexpr size_t width = 16;
+                static constexpr size_t alignment = 64;
+                static reg loadu(const T* p) { return _mm512_loadu_si512(p); }
+                static void store(T* p, reg v) { _mm512_store_si512(p, v); }
+                static void storeu(T* p, reg v) { _mm512_storeu_si512(p, v); }
+                static void stream(T* p, reg v) { _mm512_stream_si512(reinterpret_cast<__m512i*>(p), v); }
+                static reg set1(T v) { return _mm512_set1_epi32(static_cast<int>(v)); }
+                static reg add(reg a, reg b) { return _mm512_add_epi32(a, b); }
+                static reg sub(reg a, reg b) { return _mm512_sub_epi32(a, b); }
+                static reg mul(reg a, reg b) { return _mm512_mullo_epi32(a, b); }
+            };
+
+            template<typename T>
+            struct VecOps<T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) == 8>>
+            {
+                using reg = __m512i;
+                static constexpr bool available = true;
+#if defined(__AVX512DQ__)
+                static constexpr bool hasMul = true;
+                static reg mul(reg a, reg b) { return _mm512_mullo_epi64(a, b); }
+#else
+                static constexpr bool hasMul = false;
+#endif
+                static constexpr size_t width = 8;
+                static constexpr size_t alignment = 64;
+                static reg loadu(const T* p) { return _mm512_loadu_si512(p); }
+                static void store(T* p, reg v) { _mm512_store_si512(p, v); }
+                static void storeu(T* p, reg v) { _mm512_storeu_si512(p, v); }
+                static void stream(T* p, reg v) { _mm512_stream_si512(reinterpret_cast<__m512i*>(p), v); }
+                static reg set1(T v) { return _mm512_set1_epi64(static_cast<long long>(v)); }
+                static reg add(reg a, reg b) { return _mm512_add_epi64(a, b); }
+                static reg sub(reg a, reg b) { return _mm512_sub_epi64(a, b); }
+            };
+#elif defined(__AVX2__)
+            template<>
+            struct VecOps<float>
+            {
+                using reg = __m256;
+                static constexpr bool available = true;
+                static constexpr bool hasMul = true;
+                static constexpr size_t width = 8;
+                static constexpr size_t alignment = 32;
+                static reg loadu(const float* p) { return _mm256_loadu_ps(p); }
+                static void store(float* p, reg v) { _mm256_store_ps(p, v); }
+                static void storeu(float* p, reg v) { _mm256_storeu_ps(p, v); }
+                static void stream(float* p, reg v) { _mm256_stream_ps(p, v); }
+                static reg set1(float v) { return _mm256_set1_ps(v); }
+                static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+                static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+                static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+                static reg abs(reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+                static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+                static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+                static bool allLe(reg a, reg b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ)) == 0xFF; }
+                static float hmax(reg a)
+                {
+                    const __m128 m = _mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+                    const __m128 p = _mm_max_ps(m, _mm_movehl_ps(m, m));
+                    return _mm_cvtss_f32(_mm_max_ss(p, _mm_shuffle_ps(p, p, 1)));
+                }
+            };
+
+            template<>
+            struct VecOps<double>
+            {
+                using reg = __m256d;
+                static constexpr bool available = true;
+                static constexpr bool hasMul = true;
+                static constexpr size_t width = 4;
+                static constexpr size_t alignment = 32;
+                static reg loadu(const double* p) { return _mm256_loadu_pd(p); }
+                static void store(double* p, reg v) { _mm256_store_pd(p, v); }
+                static void storeu(double* p, reg v) { _mm256_storeu_pd(p, v); }
+                static void stream(double* p, reg v) { _mm256_stream_pd(p, v); }
+                static reg set1(double v) { return _mm256_set1_pd(v); }
+                static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+                static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+                static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+                static reg abs(reg a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+                static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+                static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+                static bool allLe(reg a, reg b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ)) == 0xF; }
+                static double hmax(reg a)
+                {
+                    const __m128d m = _mm_max_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+                    return _mm_cvtsd_f64(_mm_max_sd(m, _mm_unpackhi_pd(m, m)));
+                }
+            };
+
+            template<typename T>
+            struct VecOps<T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) == 4>>
+            {
+                using reg = __m256i;
+                static constexpr bool available = true;
+                static constexpr bool hasMul = true;
+                static constexpr size_t width = 8;
+                static constexpr size_t alignment = 32;
+                static reg loadu(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+                static void store(T* p, reg v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+                static void storeu(T* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+                static void stream(T* p, reg v) { _mm256_stream_si256(reinterpret_cast<__m256i*>(p), v); }
+                static reg set1(T v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+                static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+                static reg sub(reg a, reg b) { return _mm256_sub_epi32(a, b); }
+                static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+            };
+
+            template<typename T>
+            struct VecOps<T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) == 8>>
+            {
+                using reg = __m256i;
+                static constexpr bool available = true;
+                static constexpr bool hasMul = false;   ///< No 64-bit mullo before AVX-512DQ.
+                static constexpr size_t width = 4;
+                static constexpr size_t alignment = 32;
+                static reg loadu(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+                static void store(T* p, reg v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+                static void storeu(T* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+                static void stream(T* p, reg v) { _mm256_stream_si256(reinterpret_cast<__m256i*>(p), v); }
+                static reg set1(T v) { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+                static reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+                static reg sub(reg a, reg b) { return _mm256_sub_epi64(a, b); }
+            };
+#elif defined(__SSE2__)
+            template<>
+            struct VecOps<float>
+            {
+                using reg = __m128;
+                static constexpr bool available = true;
+                static constexpr bool hasMul = true;
+                static constexpr size_t width = 4;
+                static constexpr size_t alignment = 16;
+                static reg loadu(const float* p) { return _mm_loadu_ps(p); }
+                static void store(float* p, reg v) { _mm_store_ps(p, v); }
+                static void storeu(float* p, reg v) { _mm_storeu_ps(p, v); }
+                static void stream(float* p, reg v) { _mm_stream_ps(p, v); }
+                static reg set1(float v) { return _mm_set1_ps(v); }
+                static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+                static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+                static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+                static reg abs(reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+                static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+                static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+                static bool allLe(reg a, reg b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)) == 0xF; }
+                static float hmax(reg a)
+                {
+                    const __m128 p = _mm_max_ps(a, _mm_movehl_ps(a, a));
+                    return _mm_cvtss_f32(_mm_max_ss(p, _mm_shuffle_ps(p, p, 1)));
+                }
+            };
+
+            template<>
+            struct VecOps<double>
+            {
+                using reg = __m128d;
+                static constexpr bool available = true;
+                static constexpr bool hasMul = true;
+                static constexpr size_t width = 2;
+                static constexpr size_t alignment = 16;
+                static reg loadu(const double* p) { return _mm_loadu_pd(p); }
+                static void store(double* p, reg v) { _mm_store_pd(p, v); }
+                static void storeu(double* p, reg v) { _mm_storeu_pd(p, v); }
+                static void stream(double* p, reg v) { _mm_stream_pd(p, v); }
+                static reg set1(double v) { return _mm_set1_pd(v); }
+                static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+                static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+                static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+                static reg abs(reg a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+                static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+                static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+                static bool allLe(reg a, reg b) { return _mm_movemask_pd(_mm_cmple_pd(a, b)) == 0x3; }
+                static double hmax(reg a) { return _mm_cvtsd_f64(_mm_max_sd(a, _mm_unpackhi_pd(a, a))); }
+            };
+
+            template<typename T>
+            struct VecOps<T, std::enable_if_t<std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)>>
+            {
+                using reg = __m128i;
+                static constexpr bool available = true;
+#if defined(__SSE4_1__)
+                static constexpr bool hasMul = sizeof(T) == 4;
+#else
+                static constexpr bool hasMul = false;
+#endif
+                static constexpr size_t width = 16 / sizeof(T);
+                static constexpr size_t alignment = 16;
+                static reg loadu(const T* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+                static void store(T* p, reg v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+                static void storeu(T* p, reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+                static void stream(T* p, reg v) { _mm_stream_si128(reinterpret_cast<__m128i*>(p), v); }
+                static reg set1(T v)
+                {
+                    if constexpr (sizeof(T) == 4) return _mm_set1_epi32(static_cast<int>(v));
+                    else return _mm_set1_epi64x(static_cast<long long>(v));
+                }
+                static reg add(reg a, reg b)
+                {
+                    if constexpr (sizeof(T) == 4) return _mm_add_epi32(a, b);
+                    else return _mm_add_epi64(a, b);
+                }
+                static reg sub(reg a, reg b)
+                {
+                    if constexpr (sizeof(T) == 4) return _mm_sub_epi32(a, b);
+                    else return _mm_sub_epi64(a, b);
+                }
+#if defined(__SSE4_1__)
+                static reg mul(reg a, reg b) { return _mm_mullo_epi32(a, b); }
+#endif
+            };
+#endif
+
+            /// @brief Elements per register for T, or 1 when T has no vector ops.
+            template<typename T>
+            constexpr size_t widthOf()
+            {
+                if constexpr (VecOps<T>::available)
+                    return VecOps<T>::width;
+                else
+                    return 1;
+            }
+
+            /// @brief Which arithmetic a standard functor performs, if any.
+            enum class OpKind { None, Add, Sub, Mul };
+
+            template<typename Op, typename T>
+            constexpr OpKind opKind()
+            {
+                if constexpr (std::is_same_v<Op, std::plus<T>> || std::is_same_v<Op, std::plus<>>)
+                    return OpKind::Add;
+                else if constexpr (std::is_same_v<Op, std::minus<T>> || std::is_same_v<Op, std::minus<>>)
+                    return OpKind::Sub;
+                else if constexpr (std::is_same_v<Op, std::multiplies<T>> || std::is_same_v<Op, std::multiplies<>>)
+                    return OpKind::Mul;
+                else
+                    return OpKind::None;
+            }
+
+            /**
+             * @brief true if op on T has a hand-vectorized kernel in this build.
+             */
+            template<typename Op, typename T>
+            constexpr bool hasKernel()
+            {
+                constexpr OpKind kind = opKind<Op, T>();
+                if constexpr (kind == OpKind::None || !VecOps<T>::available)
+                    return false;
+                else
+                    return kind != OpKind::Mul || VecOps<T>::hasMul;
+            }
+
+            template<OpKind Kind, typename V, typename R>
+            inline R apply(R a, R b)
+            {
+                if constexpr (Kind == OpKind::Add) return V::add(a, b);
+                else if constexpr (Kind == OpKind::Sub) return V::sub(a, b);
+                else return V::mul(a, b);
+            }
+
+            template<OpKind Kind, typename T>
+            inline T applyScalar(T a, T b)
+            {
+                if constexpr (Kind == OpKind::Add) return a + b;
+                else if constexpr (Kind == OpKind::Sub) return a - b;
+                else return a * b;
+            }
+
+            /**
+             * @brief Runs a vector loop over [0, n) with scalar head and tail.
+             *
+             * The head is peeled until out is aligned to the register width, so
+             * the body uses aligned (or non-temporal) stores while inputs are read
+             * with unaligned loads; the tail covers the last partial register.
+             *
+             * @param nonTemporal Bypass the cache for the stores (see config::nonTemporalBytes).
+             * @param vec body(i) computing the register for elements [i, i + width).
+             * @param scalar scalar(i) computing element i.
+             */
+            template<typename T, typename VecBody, typename ScalarBody>
+            inline void stripMine(T* out, size_t n, bool nonTemporal, VecBody vec, ScalarBody scalar)
+            {
+                using V = VecOps<T>;
+                size_t i = 0;
+                while (i < n && (reinterpret_cast<std::uintptr_t>(out + i) % V::alignment) != 0)
+                {
+                    out[i] = scalar(i);
+                    ++i;
+                }
+
+                if (nonTemporal)
+                {
+                    for (; i + V::width <= n; i += V::width)
+                        V::stream(out + i, vec(i));
+#if defined(__SSE2__)
+                    _mm_sfence();
+#endif
+                }
+                else
+                {
+                    for (; i + V::width <= n; i += V::width)
+                        V::store(out + i, vec(i));
+                }
+
+                for (; i < n; ++i)
+                    out[i] = scalar(i);
+            }
+
+            /**
+             * @brief true if writing totalBytes of output should bypass the cache.
+             *
+             * Decided on the whole output rather than per chunk, so a large
+             * result split across threads still streams.
+             */
+            inline bool useNonTemporal(size_t totalBytes)
+            {
+                return totalBytes >= config::nonTemporalBytes;
+            }
+
+            /**
+             * @brief out[i] = op(a[i], b[i]) for the standard arithmetic functors.
+             */
+            template<typename Op, typename T>
+            inline void binary(const T* a, const T* b, T* out, size_t n, bool nonTemporal)
+            {
+                static_assert(hasKernel<Op, T>(), "No vector kernel for this operation");
+                using V = VecOps<T>;
+                constexpr OpKind kind = opKind<Op, T>();
+                stripMine(out, n, nonTemporal,
+                          [=](size_t i) { return apply<kind, V>(V::loadu(a + i), V::loadu(b + i)); },
+                          [=](size_t i) { return applyScalar<kind>(a[i], b[i]); });
+            }
+
+            /**
+             * @brief out[i] = a[i] * scalar.
+             */
+            template<typename T>
+            inline void scale(const T* a, T scalar, T* out, size_t n, bool nonTemporal)
+            {
+                using V = VecOps<T>;
+                static_assert(V::hasMul, "No vector multiply for this type");
+                const typename V::reg s = V::set1(scalar);
+                stripMine(out, n, nonTemporal,
+                          [=](size_t i) { return V::mul(V::loadu(a + i), s); },
+                          [=](size_t i) { return a[i] * scalar; });
+            }
+
+            /// @brief Sum of the lanes of a register.
+            template<typename V, typename T>
+            inline T reduceLanes(typename V::reg v)
+            {
+                alignas(64) T lanes[V::width];
+                V::store(lanes, v);
+                T total = T{};
+                for (size_t i = 0; i < V::width; ++i)
+                    total += lanes[i];
+                return total;
+            }
+
+            /**
+             * @brief Sum of a[0, n).
+             *
+             * Four independent register accumulators hide the add latency; the
+             * summation order is fixed for a given n and build.
+             */
+            template<typename T>
+            inline T sum(const T* a, size_t n)
+            {
+                T total = T{};
+                size_t i = 0;
+                if constexpr (VecOps<T>::available)
+                {
+                    using V = VecOps<T>;
+                    typename V::reg acc[4] = {V::set1(T{}), V::set1(T{}), V::set1(T{}), V::set1(T{})};
+                    for (; i + (4 * V::width) <= n; i += 4 * V::width)
+                        for (size_t u = 0; u < 4; ++u)
+                            acc[u] = V::add(acc[u], V::loadu(a + i + (u * V::width)));
+                    for (; i + V::width <= n; i += V::width)
+                        acc[0] = V::add(acc[0], V::loadu(a + i));
+                    total = reduceLanes<V, T>(V::add(V::add(acc[0], acc[1]), V::add(acc[2], acc[3])));
+                }
+                for (; i < n; ++i)
+                    total += a[i];
+                return total;
+            }
+
+            /**
+             * @brief Inner product of a[0, n) and b[0, n), with the same blocking as sum().
+             */
+            template<typename T>
+            inline T dot(const T* a, const T* b, size_t n)
+            {
+                T total = T{};
+                size_t i = 0;
+                if constexpr (VecOps<T>::hasMul)
+                {
+                    using V = VecOps<T>;
+                    typename V::reg acc[4] = {V::set1(T{}), V::set1(T{}), V::set1(T{}), V::set1(T{})};
+                    for (; i + (4 * V::width) <= n; i += 4 * V::width)
+                        for (size_t u = 0; u < 4; ++u)
+                            acc[u] = V::add(acc[u], V::mul(V::loadu(a + i + (u * V::width)), V::loadu(b + i + (u * V::width))));
+                    for (; i + V::width <= n; i += V::width)
+                        acc[0] = V::add(acc[0], V::mul(V::loadu(a + i), V::loadu(b + i)));
+                    total = reduceLanes<V, T>(V::add(V::add(acc[0], acc[1]), V::add(acc[2], acc[3])));
+                }
+                for (; i < n; ++i)
+                    total += a[i] * b[i];
+                return total;
+            }
+
+            /**
+             * @brief Scalar tolerance test: |a - b| <= atol + rtol * |b|, or a == b.
+             *
+             * The a == b term makes equal infinities close; NaN is never close.
+             */
+            template<typename T>
+            inline bool isClose(T a, T b, double rtol, double atol)
+            {
+                if (a == b)
+                    return true;
+                const double da = static_cast<double>(a);
+                const double db = static_cast<double>(b);
+                return std::abs(da - db) <= atol + (rtol * std::abs(db));
+            }
+
+            /// @brief true if T has vectorized comparison kernels in this build.
+            template<typename T>
+            constexpr bool hasCompareKernel()
+            {
+                if constexpr (std::is_floating_point_v<T>)
+                    return VecOps<T>::available;
+                else
+                    return false;
+            }
+
+            /**
+             * @brief true if isClose() holds for every pair, stopping at the first failure.
+             *
+             * Registers that fail the vector test are re-checked lane by lane,
+             * so infinities get the exact scalar semantics.
+             */
+            template<typename T>
+            inline bool allClose(const T* a, const T* b, size_t n, double rtol, double atol)
+            {
+                size_t i = 0;
+                if constexpr (hasCompareKernel<T>())
+                {
+                    using V = VecOps<T>;
+                    const typename V::reg vr = V::set1(static_cast<T>(rtol));
+                    const typename V::reg va = V::set1(static_cast<T>(atol));
+                    for (; i + V::width <= n; i += V::width)
+                    {
+                        const typename V::reg x = V::loadu(a + i);
+                        const typename V::reg y = V::loadu(b + i);
+                        const typename V::reg diff = V::abs(V::sub(x, y));
+                        const typename V::reg tol = V::add(va, V::mul(vr, V::abs(y)));
+                        if (V::allLe(diff, tol))
+                            continue;
+                        for (size_t k = i; k < i + V::width; ++k)
+                            if (!isClose(a[k], b[k], rtol, atol))
+                                return false;
+                    }
+                }
+                for (; i < n; ++i)
+                    if (!isClose(a[i], b[i], rtol, atol))
+                        return false;
+                return true;
+            }
+
+            /**
+             * @brief max |a[i] - b[i]|, or NaN as soon as any difference is NaN.
+             */
+            template<typename T>
+            inline T maxAbsDiff(const T* a, const T* b, size_t n)
+            {
+                static_assert(std::is_floating_point_v<T>, "maxAbsDiff requires a floating point type");
+                constexpr T inf = std::numeric_limits<T>::infinity();
+                T best = T{0};
+                size_t i = 0;
+                if constexpr (hasCompareKernel<T>())
+                {
+                    using V = VecOps<T>;
+                    const typename V::reg vinf = V::set1(inf);
+                    typename V::reg acc = V::set1(T{0});
+                    for (; i + V::width <= n; i += V::width)
+                    {
+                        const typename V::reg diff = V::abs(V::sub(V::loadu(a + i), V::loadu(b + i)));
+                        if (!V::allLe(diff, vinf))
+                            return std::numeric_limits<T>::quiet_NaN();
+                        acc = V::max(acc, diff);
+                    }
+                    best = V::hmax(acc);
+                }
+                for (; i < n; ++i)
+                {
+                    const T diff = std::abs(a[i] - b[i]);
+                    if (std::isnan(diff))
+                        return std::numeric_limits<T>::quiet_NaN();
+                    best = std::max(best, diff);
+                }
+                return best;
+            }
+
+            /**
+             * @brief Maps a float onto an integer line where adjacent representable values differ by 1.
+             */
+            template<typename T>
+            inline int64_t orderedBits(T value)
+            {
+                static_assert(std::is_floating_point_v<T> && (sizeof(T) == 4 || sizeof(T) == 8),
+                              "ULP distance requires float or double");
+                if constexpr (sizeof(T) == 4)
+                {
+                    int32_t bits;
+                    std::memcpy(&bits, &value, sizeof bits);
+                    return bits < 0 ? static_cast<int64_t>(INT32_MIN) - bits : bits;
+                }
+                else
+                {
+                    int64_t bits;
+                    std::memcpy(&bits, &value, sizeof bits);
+                    return bits < 0 ? INT64_MIN - bits : bits;
+                }
+            }
+
+            /**
+             * @brief Largest ULP distance between a[i] and b[i], stopping once it exceeds limit.
+             *
+             * NaN counts as an infinite distance. The branch-free loop body is
+             * left to the auto-vectorizer.
+             *
+             * @return The maximum distance, or a value > limit on early exit.
+             */
+            template<typename T>
+            inline uint64_t maxUlpDistance(const T* a, const T* b, size_t n, uint64_t limit)
+            {
+                constexpr size_t block = 256;
+                uint64_t best = 0;
+                for (size_t first = 0; first < n; first += block)
+                {
+                    const size_t last = std::min(n, first + block);
+                    uint64_t blockMax = 0;
+                    bool nan = false;
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        const int64_t x = orderedBits(a[i]);
+                        const int64_t y = orderedBits(b[i]);
+                        const uint64_t d = x > y ? static_cast<uint64_t>(x) - static_cast<uint64_t>(y)
+                                                 : static_cast<uint64_t>(y) - static_cast<uint64_t>(x);
+                        blockMax = std::max(blockMax, d);
+                        nan |= (a[i] != a[i]) | (b[i] != b[i]);
+                    }
+                    if (nan)
+                        return std::numeric_limits<uint64_t>::max();
+                    best = std::max(best, blockMax);
+                    if (best > limit)
+                        return best;
+                }
+                return best;
+            }
+        }
+    }
+}
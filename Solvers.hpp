@@ -0,0 +1,452 @@
+/**
+ * @file Solvers.hpp
+ * @brief Iterative linear solvers (CG, preconditioned CG, GMRES) on Tensor.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Tensor.hpp"
+
+namespace Tensor
+{
+    /**
+     * @brief A square linear map y = Op(x) on column vectors.
+     *
+     * Lets the solvers run on matrix-free operators (stencils, sparse
+     * formats, KroneckerView, ...) as well as on dense tensors.
+     *
+     * @tparam T Floating point type.
+     */
+    template<typename T>
+    class LinearOperator
+    {
+    public:
+        virtual ~LinearOperator() = default;
+
+        /**
+         * @brief Returns the dimension n of the n x n operator.
+         *
+         * @return Number of rows (and columns).
+         */
+        virtual size_t size() const = 0;
+
+        /**
+         * @brief Computes y = Op(x).
+         *
+         * @param x Input column vector (n x 1).
+         * @param y Output column vector (n x 1), already allocated; never aliases x.
+         */
+        virtual void apply(const Tensor<T>& x, Tensor<T>& y) const = 0;
+    };
+
+    /**
+     * @brief LinearOperator view of a dense square tensor.
+     *
+     * @tparam T Floating point type.
+     * @tparam Layout Storage layout of the matrix.
+     */
+    template<typename T, typename Layout = RowMajor>
+    class MatrixOperator : public LinearOperator<T>
+    {
+    private:
+        const Tensor<T, Layout>& matrix;   ///< Referenced, must outlive the operator.
+
+    public:
+        /**
+         * @brief Wraps a matrix.
+         *
+         * @param a Square matrix.
+         * @throws std::runtime_error if the matrix is not square.
+         */
+        explicit MatrixOperator(const Tensor<T, Layout>& a)
+            : matrix(a)
+        {
+            if(a.rowCount() != a.colCount())
+                TENSOR_THROW(std::runtime_error, "Matrix is not square");
+        }
+
+        size_t size() const override { return matrix.rowCount(); }
+
+        void apply(const Tensor<T>& x, Tensor<T>& y) const override
+        {
+            if constexpr (std::is_same<Layout, RowMajor>::value)
+                matrix.multiplyInto(x, y);
+            else
+            {
+                // Into y's own storage: callers may hold pointers into it.
+                const Tensor<T, Layout> product = matrix * x.template toLayout<Layout>();
+                T* out = detail::TensorAccess::storage(y);
+                for (size_t i = 0; i < product.rowCount(); ++i)
+                    out[i] = product(i, 0);
+            }
+        }
+    };
+
+    /**
+     * @brief Jacobi (diagonal) preconditioner, y = D^-1 x.
+     *
+     * @tparam T Floating point type.
+     */
+    template<typename T>
+    class JacobiPreconditioner : public LinearOperator<T>
+    {
+    private:
+        std::vector<T> inverseDiagonal;
+
+    public:
+        /**
+         * @brief Builds the preconditioner from the diagonal of a.
+         *
+         * @tparam Layout Layout of the matrix.
+         * @param a Square matrix with a non-zero diagonal.
+         * @throws std::runtime_error if the matrix is not square or has a zero on the diagonal.
+         */
+        template<typename Layout>
+        explicit JacobiPreconditioner(const Tensor<T, Layout>& a)
+            : inverseDiagonal(a.rowCount())
+        {
+            if(a.rowCount() != a.colCount())
+                TENSOR_THROW(std::runtime_error, "Matrix is not square");
+            for (size_t i = 0; i < a.rowCount(); ++i)
+            {
+                if (a(i, i) == T{0})
+                    TENSOR_THROW(std::runtime_error, "Zero on the diagonal");
+                inverseDiagonal[i] = T{1} / a(i, i);
+            }
+        }
+
+        size_t size() const override { return inverseDiagonal.size(); }
+
+        void apply(const Tensor<T>& x, Tensor<T>& y) const override
+        {
+            const T* in = detail::TensorAccess::storage(x);
+            T* out = detail::TensorAccess::storage(y);
+            for (size_t i = 0; i < inverseDiagonal.size(); ++i)
+                out[i] = in[i] * inverseDiagonal[i];
+        }
+    };
+
+    /**
+     * @brief Stopping criteria of the iterative solvers.
+     */
+    struct SolverOptions
+    {
+        size_t maxIterations = 1000;   ///< Upper bound on operator applications.
+        double tolerance = 1e-8;       ///< Stop once ||b - A x|| <= tolerance * ||b||.
+        size_t restart = 30;           ///< GMRES Krylov subspace size before restarting.
+    };
+
+    /**
+     * @brief Outcome of an iterative solve.
+     */
+    struct SolverResult
+    {
+        size_t iterations = 0;         ///< Iterations performed.
+        double residual = 0;           ///< Final relative residual ||b - A x|| / ||b|| (as tracked by the method).
+        bool converged = false;        ///< Whether the tolerance was reached.
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief The fused CG update: x += alpha * p, r -= alpha * q, returns r . r.
+         *
+         * One pass over four vectors instead of three separate sweeps.
+         */
+        template<typename T>
+        T cgUpdate(T* x, T* r, const T* p, const T* q, T alpha, size_t n)
+        {
+            T rr = T{};
+            size_t i = 0;
+            if constexpr (simd::VecOps<T>::hasMul)
+            {
+                using V = simd::VecOps<T>;
+                const typename V::reg a = V::set1(alpha);
+                typename V::reg acc = V::set1(T{});
+                for (; i + V::width <= n; i += V::width)
+                {
+                    V::storeu(x + i, V::add(V::loadu(x + i), V::mul(a, V::loadu(p + i))));
+                    const typename V::reg ri = V::sub(V::loadu(r + i), V::mul(a, V::loadu(q + i)));
+                    V::storeu(r + i, ri);
+                    acc = V::add(acc, V::mul(ri, ri));
+                }
+                rr = simd::reduceLanes<V, T>(acc);
+            }
+            for (; i < n; ++i)
+            {
+                x[i] += alpha * p[i];
+                r[i] -= alpha * q[i];
+                rr += r[i] * r[i];
+            }
+            return rr;
+        }
+
+        /// @brief p = z + beta * p.
+        template<typename T>
+        void xpby(const T* z, T beta, T* p, size_t n)
+        {
+            size_t i = 0;
+            if constexpr (simd::VecOps<T>::hasMul)
+            {
+                using V = simd::VecOps<T>;
+                const typename V::reg b = V::set1(beta);
+                for (; i + V::width <= n; i += V::width)
+                    V::storeu(p + i, V::add(V::loadu(z + i), V::mul(b, V::loadu(p + i))));
+            }
+            for (; i < n; ++i)
+                p[i] = z[i] + (beta * p[i]);
+        }
+
+        /// @brief y += alpha * x.
+        template<typename T>
+        void axpy(T alpha, const T* x, T* y, size_t n)
+        {
+            size_t i = 0;
+            if constexpr (simd::VecOps<T>::hasMul)
+            {
+                using V = simd::VecOps<T>;
+                const typename V::reg a = V::set1(alpha);
+                for (; i + V::width <= n; i += V::width)
+                    V::storeu(y + i, V::add(V::loadu(y + i), V::mul(a, V::loadu(x + i))));
+            }
+            for (; i < n; ++i)
+                y[i] += alpha * x[i];
+        }
+
+        /// @brief Checks that a and the vectors agree on n and that the vectors are contiguous n x 1.
+        template<typename T>
+        void checkSystem(const LinearOperator<T>& a, const Tensor<T>& b, const Tensor<T>& x)
+        {
+            if (b.colCount() != 1 || x.colCount() != 1)
+                TENSOR_THROW(std::invalid_argument, "Right-hand side and solution must be column vectors");
+            if (b.rowCount() != a.size() || x.rowCount() != a.size())
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+            if (!b.isContiguous() || !x.isContiguous())
+                TENSOR_THROW(std::invalid_argument, "Right-hand side and solution must be contiguous");
+        }
+
+        /// @brief r = b - A x.
+        template<typename T>
+        void residual(const LinearOperator<T>& a, const Tensor<T>& b, const Tensor<T>& x, Tensor<T>& r)
+        {
+            a.apply(x, r);
+            T* rs = TensorAccess::storage(r);
+            const T* bs = TensorAccess::storage(b);
+            for (size_t i = 0; i < b.rowCount(); ++i)
+                rs[i] = bs[i] - rs[i];
+        }
+    }
+
+    /**
+     * @brief Conjugate gradient, optionally preconditioned, for symmetric positive definite systems.
+     *
+     * Each iteration costs one operator application, one preconditioner
+     * application if one is given and three passes over the vectors: p . q, the fused
+     * x/r update with r . r, and p = z + beta p.
+     *
+     * @param a SPD operator.
+     * @param b Right-hand side (n x 1).
+     * @param x Initial guess on entry, solution on exit (n x 1).
+     * @param options Stopping criteria.
+     * @param preconditioner Optional approximation of A^-1 (SPD), e.g. JacobiPreconditioner.
+     * @return Iterations, final relative residual and convergence flag.
+     * @throws std::runtime_error if dimensions mismatch.
+     */
+    template<typename T>
+    SolverResult conjugateGradient(const LinearOperator<T>& a, const Tensor<T>& b, Tensor<T>& x,
+                                   const SolverOptions& options = {}, const LinearOperator<T>* preconditioner = nullptr)
+    {
+        static_assert(std::is_floating_point<T>::value, "Solvers require a floating point type");
+        detail::checkSystem(a, b, x);
+        using detail::TensorAccess;
+
+        const size_t n = a.size();
+        SolverResult result;
+        const T bNorm = b.norm();
+        if (bNorm == T{0})
+        {
+            x.fill(0);
+            result.converged = true;
+            return result;
+        }
+
+        Tensor<T> r(n, 1), p(n, 1), q(n, 1);
+        Tensor<T> z = preconditioner ? Tensor<T>(n, 1) : Tensor<T>(1, 1);
+        detail::residual(a, b, x, r);
+        Tensor<T>& zr = preconditioner ? z : r;
+        if (preconditioner)
+            preconditioner->apply(r, z);
+        p = zr;
+
+        T rr = r.dot(r);
+        T rz = preconditioner ? r.dot(z) : rr;
+        result.residual = static_cast<double>(std::sqrt(rr) / bNorm);
+        if (result.residual <= options.tolerance)
+        {
+            result.converged = true;
+            return result;
+        }
+
+        T* xs = TensorAccess::storage(x);
+        T* rs = TensorAccess::storage(r);
+        T* ps = TensorAccess::storage(p);
+        while (result.iterations < options.maxIterations)
+        {
+            a.apply(p, q);
+            ++result.iterations;
+            const T* qs = TensorAccess::storage(static_cast<const Tensor<T>&>(q));   // apply() may replace q's storage
+            const T pq = p.dot(q);
+            if (!(pq > T{0}))
+                break;  // Not positive definite along p (or NaN): CG can't continue.
+
+            rr = detail::cgUpdate(xs, rs, ps, qs, rz / pq, n);
+            result.residual = static_cast<double>(std::sqrt(rr) / bNorm);
+            if (result.residual <= options.tolerance)
+            {
+                result.converged = true;
+                break;
+            }
+
+            T rzNext = rr;
+            if (preconditioner)
+            {
+                preconditioner->apply(r, z);
+                rzNext = r.dot(z);
+            }
+            detail::xpby(TensorAccess::storage(static_cast<const Tensor<T>&>(zr)), rzNext / rz, ps, n);
+            rz = rzNext;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Restarted GMRES(m) for general non-singular systems.
+     *
+     * Arnoldi with modified Gram-Schmidt builds the Krylov basis, and Givens
+     * rotations keep the least-squares residual available every iteration.
+     * An optional right preconditioner M solves A M^-1 u = b, x = M^-1 u, so
+     * the tracked residual is the true one.
+     *
+     * @param a Operator.
+     * @param b Right-hand side (n x 1).
+     * @param x Initial guess on entry, solution on exit (n x 1).
+     * @param options Stopping criteria; options.restart is m.
+     * @param preconditioner Optional approximation of A^-1.
+     * @return Iterations, final relative residual and convergence flag.
+     * @throws std::runtime_error if dimensions mismatch.
+     */
+    template<typename T>
+    SolverResult gmres(const LinearOperator<T>& a, const Tensor<T>& b, Tensor<T>& x,
+                       const SolverOptions& options = {}, const LinearOperator<T>* preconditioner = nullptr)
+    {
+        static_assert(std::is_floating_point<T>::value, "Solvers require a floating point type");
+        detail::checkSystem(a, b, x);
+        using detail::TensorAccess;
+
+        const size_t n = a.size();
+        const size_t m = std::max<size_t>(1, std::min(options.restart, n));
+        SolverResult result;
+        const T bNorm = b.norm();
+        if (bNorm == T{0})
+        {
+            x.fill(0);
+            result.converged = true;
+            return result;
+        }
+
+        std::vector<Tensor<T>> basis(m + 1, Tensor<T>(n, 1));
+        Tensor<T> w(n, 1), update(n, 1);
+        std::vector<T> h((m + 1) * m), cs(m), sn(m), g(m + 1);
+        auto H = [&](size_t i, size_t j) -> T& { return h[(i * m) + j]; };
+        auto rawOf = [](const Tensor<T>& t) { return TensorAccess::storage(t); };
+
+        while (true)
+        {
+            detail::residual(a, b, x, w);
+            const T beta = w.norm();
+            result.residual = static_cast<double>(beta / bNorm);
+            if (result.residual <= options.tolerance)
+            {
+                result.converged = true;
+                return result;
+            }
+            if (result.iterations >= options.maxIterations)
+                return result;
+
+            basis[0] = w * (T{1} / beta);
+            std::fill(g.begin(), g.end(), T{});
+            g[0] = beta;
+
+            // Arnoldi steps; k ends as the dimension of the Krylov space built this cycle.
+            size_t k = 0;
+            while (k < m && result.iterations < options.maxIterations)
+            {
+                if (preconditioner)
+                {
+                    preconditioner->apply(basis[k], update);
+                    a.apply(update, w);
+                }
+                else
+                    a.apply(basis[k], w);
+                ++result.iterations;
+
+                T* ws = TensorAccess::storage(w);
+                for (size_t i = 0; i <= k; ++i)
+                {
+                    H(i, k) = w.dot(basis[i]);
+                    detail::axpy(-H(i, k), rawOf(basis[i]), ws, n);
+                }
+                const T subdiagonal = w.norm();
+                if (subdiagonal != T{0})
+                    basis[k + 1] = w * (T{1} / subdiagonal);
+
+                for (size_t i = 0; i < k; ++i)
+                {
+                    const T upper = H(i, k), lower = H(i + 1, k);
+                    H(i, k) = (cs[i] * upper) + (sn[i] * lower);
+                    H(i + 1, k) = (cs[i] * lower) - (sn[i] * upper);
+                }
+                const T radius = std::hypot(H(k, k), subdiagonal);
+                cs[k] = radius == T{0} ? T{1} : H(k, k) / radius;
+                sn[k] = radius == T{0} ? T{0} : subdiagonal / radius;
+                H(k, k) = radius;
+                g[k + 1] = -sn[k] * g[k];
+                g[k] = cs[k] * g[k];
+                ++k;
+
+                result.residual = static_cast<double>(std::abs(g[k]) / bNorm);
+                if (result.residual <= options.tolerance || subdiagonal == T{0})
+                    break;
+            }
+
+            // Back-substitute R y = g and fold V y (through M^-1) into x.
+            for (size_t i = k; i-- > 0;)
+            {
+                T yi = g[i];
+                for (size_t j = i + 1; j < k; ++j)
+                    yi -= H(i, j) * g[j];
+                g[i] = H(i, i) == T{0} ? T{0} : yi / H(i, i);
+            }
+            update.fill(0);
+            T* us = TensorAccess::storage(update);
+            for (size_t i = 0; i < k; ++i)
+                detail::axpy(g[i], rawOf(basis[i]), us, n);
+            if (preconditioner)
+            {
+                preconditioner->apply(update, w);
+                detail::axpy(T{1}, rawOf(w), TensorAccess::storage(x), n);
+            }
+            else
+                detail::axpy(T{1}, static_cast<const T*>(us), TensorAccess::storage(x), n);
+        }
+    }
+}
@@ -8,214 +8,2037 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <vector>
 
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#include "Error.hpp"
+#include "Gemm.hpp"
+#include "Hash.hpp"
+#include "Parallel.hpp"
+#include "Semiring.hpp"
+#include "Simd.hpp"
+
 namespace Tensor
 {
+    namespace config
+    {
+        /**
+         * @brief Whether Tensor(rows, cols) pads the leading dimension of pathological shapes.
+         *
+         * Off by default so that tensors stay contiguous (see Tensor::begin());
+         * Tensor::padded() applies the padding regardless of this setting.
+         */
+        inline bool padLeadingDimension = false;
+
+        /**
+         * @brief Whether matrix products exploit zero, identity, diagonal and triangular operands.
+         *
+         * Off by default, so products keep IEEE semantics: 0 * inf and
+         * 0 * NaN are NaN and reach the result. When on, products skip the
+         * multiplications by an operand's known zeros, so an infinity or NaN
+         * in the other operand that only meets those zeros doesn't reach the
+         * result (as with config::sparseGemm). Only structure recorded by a
+         * factory (eye(), diag()), by transpose() or by detectStructure() is
+         * used; products never scan their operands for it.
+         */
+        inline bool structuredProducts = false;
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief Leading dimension for lines of `length` elements that avoids cache-set aliasing.
+         *
+         * A line stride that is a multiple of 512 bytes maps a walk across
+         * lines onto at most 8 of the 64 sets of a typical 4-way 32 KiB L1
+         * (and likewise few L2 sets), so column walks evict each other. One
+         * extra cache line per stride spreads them over all sets.
+         */
+        inline size_t paddedLineLength(size_t length, size_t elementBytes)
+        {
+            const size_t bytes = length * elementBytes;
+            if (bytes < 512 || bytes % 512 != 0)
+                return length;
+            return length + std::max<size_t>(1, cacheLine / elementBytes);
+        }
+    }
+
+    /**
+     * @brief Row-major storage: element (i, j) lives at values[i * ld + j].
+     *
+     * Every layout policy exposes the same static interface, so Tensor and the
+     * kernels never hard-code an indexing formula:
+     *  - defaultLd(): smallest (unpadded) leading dimension for a given shape,
+     *  - paddedLd(): leading dimension with padding against cache-set aliasing,
+     *  - validLd(): whether a leading dimension can hold a given shape,
+     *  - storageSize(): number of stored elements (including padding),
+     *  - offset(): flat index of element (i, j),
+     *  - lineCount() / forEachRun(): the logical elements as contiguous runs,
+     *    grouped in independent "lines" (rows, columns or tile rows),
+     *  - gemm(): C += A * B for three tensors stored in this layout, over a semiring.
+     */
+    struct RowMajor
+    {
+        static constexpr size_t defaultLd(size_t /*rows*/, size_t cols) { return cols; }
+        static size_t paddedLd(size_t /*rows*/, size_t cols, size_t elementBytes) { return detail::paddedLineLength(cols, elementBytes); }
+        static constexpr bool validLd(size_t /*rows*/, size_t cols, size_t ld) { return ld >= cols; }
+        static constexpr size_t storageSize(size_t rows, size_t /*cols*/, size_t ld) { return rows * ld; }
+        static constexpr size_t offset(size_t i, size_t j, size_t ld) { return (i * ld) + j; }
+        static constexpr size_t lineCount(size_t rows, size_t /*cols*/) { return rows; }
+
+        template<typename F>
+        static void forEachRun(size_t /*rows*/, size_t cols, size_t ld, size_t firstLine, size_t lastLine, F&& f)
+        {
+            for (size_t i = firstLine; i < lastLine; ++i)
+                f(i * ld, cols);
+        }
+
+        template<typename T, typename S = PlusTimes<T>>
+        static void gemm(size_t M, size_t N, size_t K,
+                         const T* a, size_t lda, const T* b, size_t ldb, T* c, size_t ldc)
+        {
+            detail::gemm<T, S>(M, N, K, a, lda, b, ldb, c, ldc);
+        }
+    };
+
+    /**
+     * @brief Column-major (Fortran order) storage: element (i, j) lives at values[j * ld + i].
+     */
+    struct ColMajor
+    {
+        static constexpr size_t defaultLd(size_t rows, size_t /*cols*/) { return rows; }
+        static size_t paddedLd(size_t rows, size_t /*cols*/, size_t elementBytes) { return detail::paddedLineLength(rows, elementBytes); }
+        static constexpr bool validLd(size_t rows, size_t /*cols*/, size_t ld) { return ld >= rows; }
+        static constexpr size_t storageSize(size_t /*rows*/, size_t cols, size_t ld) { return cols * ld; }
+        static constexpr size_t offset(size_t i, size_t j, size_t ld) { return (j * ld) + i; }
+        static constexpr size_t lineCount(size_t /*rows*/, size_t cols) { return cols; }
+
+        template<typename F>
+        static void forEachRun(size_t rows, size_t /*cols*/, size_t ld, size_t firstLine, size_t lastLine, F&& f)
+        {
+            for (size_t j = firstLine; j < lastLine; ++j)
+                f(j * ld, rows);
+        }
+
+        template<typename T, typename S = PlusTimes<T>>
+        static void gemm(size_t M, size_t N, size_t K,
+                         const T* a, size_t lda, const T* b, size_t ldb, T* c, size_t ldc)
+        {
+            // A column-major matrix is the row-major storage of its transpose: C^T = B^T * A^T.
+            detail::gemm<T, S>(N, M, K, b, ldb, a, lda, c, ldc);
+        }
+    };
+
+    /**
+     * @brief Blocked storage of Tile x Tile row-major tiles, tiles laid out row by row.
+     *
+     * Edge tiles are zero padded, so ld is the column count rounded up to a
+     * multiple of Tile and every tile is a contiguous Tile * Tile block. The
+     * matrix product then runs tile by tile on cache-resident operands.
+     *
+     * @tparam Tile Tile edge length.
+     */
+    template<size_t Tile = 32>
+    struct Blocked
+    {
+        static_assert(Tile > 0, "Tile size can't be 0");
+
+        static constexpr size_t roundUp(size_t n) { return ((n + Tile - 1) / Tile) * Tile; }
+        static constexpr size_t defaultLd(size_t /*rows*/, size_t cols) { return roundUp(cols); }
+        /// Tiles are contiguous and walked whole, so there is no stride to pad.
+        static constexpr size_t paddedLd(size_t rows, size_t cols, size_t /*elementBytes*/) { return defaultLd(rows, cols); }
+        static constexpr bool validLd(size_t /*rows*/, size_t cols, size_t ld) { return ld >= cols && ld % Tile == 0; }
+        static constexpr size_t storageSize(size_t rows, size_t /*cols*/, size_t ld) { return roundUp(rows) * ld; }
+        static constexpr size_t offset(size_t i, size_t j, size_t ld)
+        {
+            return ((i / Tile) * ld * Tile) + ((j / Tile) * Tile * Tile) + ((i % Tile) * Tile) + (j % Tile);
+        }
+        static constexpr size_t lineCount(size_t rows, size_t /*cols*/) { return (rows + Tile - 1) / Tile; }
+
+        template<typename F>
+        static void forEachRun(size_t rows, size_t cols, size_t ld, size_t firstLine, size_t lastLine, F&& f)
+        {
+            for (size_t ti = firstLine; ti < lastLine; ++ti)
+            {
+                const size_t tileRows = std::min(Tile, rows - (ti * Tile));
+                for (size_t tj = 0; tj * Tile < cols; ++tj)
+                {
+                    const size_t tileCols = std::min(Tile, cols - (tj * Tile));
+                    const size_t base = (ti * ld * Tile) + (tj * Tile * Tile);
+                    if (tileRows == Tile && tileCols == Tile)
+                    {
+                        f(base, Tile * Tile);
+                        continue;
+                    }
+                    for (size_t r = 0; r < tileRows; ++r)
+                        f(base + (r * Tile), tileCols);
+                }
+            }
+        }
+
+        /// @brief Zeroes the padding of tile row ti of an M x N matrix, e.g. after a kernel wrote whole edge tiles.
+        template<typename T>
+        static void clearPadding(size_t M, size_t N, size_t ti, T* c, size_t ldc)
+        {
+            const size_t tileRows = std::min(Tile, M - (ti * Tile));
+            const size_t edgeCols = N % Tile;
+            for (size_t tj = 0; tj * Tile < ldc; ++tj)
+            {
+                T* tile = c + (ti * ldc * Tile) + (tj * Tile * Tile);
+                const size_t tileCols = (tj + 1) * Tile <= N ? Tile : (tj * Tile < N ? edgeCols : 0);
+                if (tileRows == Tile && tileCols == Tile)
+                    continue;
+                for (size_t r = 0; r < Tile; ++r)
+                    std::fill(tile + (r * Tile) + (r < tileRows ? tileCols : 0), tile + ((r + 1) * Tile), T{});
+            }
+        }
+
+        template<typename T, typename S = PlusTimes<T>>
+        static void gemm(size_t M, size_t N, size_t K,
+                         const T* a, size_t lda, const T* b, size_t ldb, T* c, size_t ldc)
+        {
+            // For (+, *) edge tiles are multiplied whole along M and N, which only writes C's padding;
+            // K stops at its logical end so padding never meets an infinity or NaN of the other operand.
+            // Other semirings walk the exact edge extents.
+            constexpr bool fullTiles = std::is_same_v<S, PlusTimes<T>>;
+            const size_t mt = (M + Tile - 1) / Tile;
+            const size_t nt = (N + Tile - 1) / Tile;
+            const size_t kt = (K + Tile - 1) / Tile;
+            auto tileRows = [&](size_t firstTile, size_t lastTile)
+            {
+                for (size_t ti = firstTile; ti < lastTile; ++ti)
+                {
+                    for (size_t tk = 0; tk < kt; ++tk)
+                    {
+                        const T* aTile = a + (ti * lda * Tile) + (tk * Tile * Tile);
+                        const size_t depth = std::min(Tile, K - (tk * Tile));
+                        for (size_t tj = 0; tj < nt; ++tj)
+                        {
+                            const T* bTile = b + (tk * ldb * Tile) + (tj * Tile * Tile);
+                            T* cTile = c + (ti * ldc * Tile) + (tj * Tile * Tile);
+                            if constexpr (fullTiles)
+                                detail::gemmRowMajor(Tile, Tile, depth, aTile, Tile, bTile, Tile, cTile, Tile);
+                            else
+                                detail::gemmRowMajor<T, S>(std::min(Tile, M - (ti * Tile)), std::min(Tile, N - (tj * Tile)),
+                                                           depth, aTile, Tile, bTile, Tile, cTile, Tile);
+                        }
+                    }
+                    if constexpr (fullTiles)
+                        clearPadding(M, N, ti, c, ldc);
+                }
+            };
+            // Each tile row of C belongs to one thread, so the result doesn't depend on the thread count.
+            if (M * N * K >= config::parallelGemmThreshold)
+                detail::parallelFor(mt, 1, tileRows);
+            else
+                tileRows(0, mt);
+        }
+    };
+
+    template<typename T, typename Layout = RowMajor>
+    class Tensor;
+
+    template<typename T>
+    class PackedTensor;
+
+    template<typename T>
+    class LU;
+
+    template<typename T>
+    class Cholesky;
+
+    template<typename T>
+    class QR;
+
+    namespace detail
+    {
+        struct TensorAccess;
+    }
+
+    namespace detail
+    {
+        /// @brief The process-wide counter behind version and write stamps.
+        inline std::atomic<uint64_t>& stampCounter()
+        {
+            static std::atomic<uint64_t> counter{0};
+            return counter;
+        }
+
+        /// @brief Hands out process-wide unique content version stamps (see Tensor::version()).
+        inline uint64_t nextVersion()
+        {
+            return stampCounter().fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        /**
+         * @brief A stamp above every one handed out so far, read without advancing the counter.
+         *
+         * Not unique: writes between two nextVersion() calls share it. That
+         * is all a write log needs, since Tensor::writeStamp() advances the
+         * counter and so orders every later write after it.
+         */
+        inline uint64_t currentStamp()
+        {
+            return stampCounter().load(std::memory_order_relaxed) + 1;
+        }
+
+        /**
+         * @brief A tensor's version stamp, which concurrent const readers may fill in; 0 means unassigned.
+         *
+         * Copies take the current value, so a copied tensor shares its version.
+         */
+        class VersionStamp
+        {
+        private:
+            std::atomic<uint64_t> value{0};
+
+        public:
+            VersionStamp() = default;
+            VersionStamp(const VersionStamp& other) noexcept : value(other.value.load(std::memory_order_relaxed)) {}
+
+            VersionStamp& operator=(const VersionStamp& other) noexcept
+            {
+                value.store(other.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                return *this;
+            }
+
+            /// @brief Forgets the stamp; the next get() hands out a new one.
+            void reset() { value.store(0, std::memory_order_relaxed); }
+
+            /// @brief The current stamp, assigning one if needed; racing callers agree on the first published.
+            uint64_t get()
+            {
+                uint64_t current = value.load(std::memory_order_relaxed);
+                if (current == 0)
+                {
+                    const uint64_t fresh = nextVersion();
+                    if (value.compare_exchange_strong(current, fresh, std::memory_order_relaxed))
+                        current = fresh;
+                }
+                return current;
+            }
+        };
+
+        /**
+         * @brief Per-line write stamps of a tensor, kept while Tensor::trackWrites() is on.
+         *
+         * Stamps come from currentStamp(), a plain load, so they order writes
+         * against Tensor::writeStamp() across tensors. Copying or moving a log stamps every line: the destination's
+         * contents were replaced wholesale, whatever the source had recorded.
+         */
+        struct WriteLog
+        {
+            struct Lines
+            {
+                uint64_t whole = 0;       ///< Latest write that may have touched any element.
+                uint64_t wholeRow = 0;    ///< Latest write of a complete row.
+                uint64_t wholeCol = 0;    ///< Latest write of a complete column.
+                std::vector<uint64_t> rowStamps, colStamps;
+            };
+
+            std::unique_ptr<Lines> lines;  ///< Null while writes aren't tracked.
+
+            WriteLog() = default;
+            WriteLog(const WriteLog& other) { *this = other; }
+            WriteLog(WriteLog&& other) noexcept { *this = std::move(other); }
+
+            WriteLog& operator=(const WriteLog& other)
+            {
+                if (this != &other)
+                {
+                    lines = other.lines ? std::make_unique<Lines>(*other.lines) : nullptr;
+                    all();
+                }
+                return *this;
+            }
+
+            WriteLog& operator=(WriteLog&& other) noexcept
+            {
+                lines = std::move(other.lines);
+                all();
+                return *this;
+            }
+
+            void all() { if (lines) lines->whole = currentStamp(); }
+
+            void element(size_t i, size_t j)
+            {
+                const uint64_t stamp = currentStamp();
+                lines->rowStamps[i] = stamp;
+                lines->colStamps[j] = stamp;
+            }
+
+            void row(size_t i)
+            {
+                const uint64_t stamp = currentStamp();
+                lines->rowStamps[i] = stamp;
+                lines->wholeRow = stamp;
+            }
+
+            void col(size_t j)
+            {
+                const uint64_t stamp = currentStamp();
+                lines->colStamps[j] = stamp;
+                lines->wholeCol = stamp;
+            }
+        };
+    }
+
+    /**
+     * @brief Rows and columns that together hold every element written since a stamp.
+     *
+     * The written elements lie in rows x cols, which may also cover elements
+     * that weren't written. See Tensor::writtenSince().
+     */
+    struct WrittenLines
+    {
+        std::vector<size_t> rows;   ///< Row indices, ascending.
+        std::vector<size_t> cols;   ///< Column indices, ascending.
+    };
+
+    /**
+     * @brief Element-wise comparison result: 1 where the predicate holds, 0 elsewhere.
+     *
+     * Bytes rather than bool, so masks keep contiguous storage and vector kernels.
+     */
+    template<typename Layout = RowMajor>
+    using Mask = Tensor<std::uint8_t, Layout>;
+
+    /**
+     * @brief Explicit leading dimension (distance between storage lines) for Tensor's constructor.
+     */
+    struct LeadingDim
+    {
+        size_t value;
+    };
+
     /**
      * @brief A simple 2D tensor (matrix) class template for numeric types.
      * 
      * @tparam T Numeric type (e.g., int, float, double).
+     * @tparam Layout Storage order policy (RowMajor, ColMajor or Blocked<Tile>).
      */
-    template<typename T>
+    template<typename T, typename Layout>
     class Tensor
     {
         static_assert(std::is_arithmetic<T>::value, "Type must be numeric");
+        static_assert(!std::is_same<T, bool>::value, "bool has no contiguous storage; use BitMatrix or Mask");
+
+        template<typename, typename> friend class Tensor;
+        template<typename> friend class PackedTensor;
+        template<typename> friend class LU;
+        template<typename> friend class Cholesky;
+        template<typename> friend class QR;
+        friend struct detail::TensorAccess;
+
+    private:
+        size_t rows, cols;             ///< Number of rows and columns.
+        size_t ld;                     ///< Leading dimension (distance between lines) in the storage.
+        std::vector<T> values;         ///< Flat storage of matrix elements in Layout order.
+
+        /// @brief Bits of `stale`: derived state that a write invalidates.
+        enum StaleBits : uint8_t { staleHash = 1, staleStructure = 4, staleAll = 0xFF };
+
+        /// @brief Bits of `structureBits`: zero patterns the elements follow.
+        enum StructureBits : uint8_t { zeroBit = 1, diagonalBit = 2, identityBit = 4, upperBit = 8, lowerBit = 16 };
+
+        bool hashTracking = false;         ///< Whether set() keeps trackedSum up to date.
+        mutable uint8_t stale = staleAll;  ///< Derived state to recompute before use (StaleBits).
+        mutable uint64_t trackedSum{};     ///< Sum of per-element hash terms, see trackedHash().
+        mutable detail::VersionStamp versionStamp; ///< Current contents identifier, see version().
+        uint8_t structureBits = 0;         ///< Known structure (StructureBits), valid unless staleStructure.
+        detail::WriteLog writeLog;         ///< Per-line write stamps, see trackWrites().
+
+        /// @brief Invalidates all derived state; a store and a test, cheap enough for operator().
+        void markWritten()
+        {
+            stale = staleAll;
+            versionStamp.reset();
+            writeLog.all();
+        }
+
+        /// @brief Leaves an empty 0 x 0 tensor whose storage has been moved out.
+        void makeEmpty() noexcept
+        {
+            values.clear();
+            rows = cols = ld = 0;
+            markWritten();
+        }
+
+        /// @brief markWritten() for a write of element (i, j) alone.
+        void markWritten(size_t i, size_t j)
+        {
+            stale = staleAll;
+            versionStamp.reset();
+            if (writeLog.lines)
+                writeLog.element(i, j);
+        }
+
+        /// @brief Records the structure of the current contents, e.g. from a factory that built them.
+        void setStructure(uint8_t bits)
+        {
+            structureBits = bits;
+            stale = static_cast<uint8_t>(stale & ~staleStructure);
+        }
+
+        /**
+         * @brief Scans the elements for the zero patterns of StructureBits.
+         *
+         * Walks in storage order and stops once no pattern can hold, which
+         * for a general matrix is after about one line.
+         */
+        uint8_t scanStructure() const
+        {
+            uint8_t bits = zeroBit | diagonalBit | upperBit | lowerBit | (rows == cols ? identityBit : 0);
+            auto visit = [&](size_t i, size_t j)
+            {
+                const T value = values[index(i, j)];
+                if (i == j)
+                {
+                    if (value != T{1})
+                        bits &= static_cast<uint8_t>(~identityBit);
+                    if (value != T{})
+                        bits &= static_cast<uint8_t>(~zeroBit);
+                }
+                else if (value != T{})
+                    bits &= static_cast<uint8_t>(~(zeroBit | diagonalBit | identityBit | (i > j ? upperBit : lowerBit)));
+            };
+            if constexpr (std::is_same<Layout, ColMajor>::value)
+            {
+                for (size_t j = 0; j < cols && bits; ++j)
+                    for (size_t i = 0; i < rows && bits; ++i)
+                        visit(i, j);
+            }
+            else
+            {
+                for (size_t i = 0; i < rows && bits; ++i)
+                    for (size_t j = 0; j < cols && bits; ++j)
+                        visit(i, j);
+            }
+            return bits;
+        }
+
+        /// @brief Structure recorded by a factory or detectStructure(), else scanned without caching it.
+        uint8_t knownStructure() const
+        {
+            return (stale & staleStructure) ? scanStructure() : structureBits;
+        }
+
+        /// @brief Structure recorded by a factory or detectStructure(), else none; never scans.
+        uint8_t recordedStructure() const
+        {
+            return (stale & staleStructure) ? 0 : structureBits;
+        }
+
+        /// @brief Flat index of element (i, j), without bounds checks.
+        size_t index(size_t i, size_t j) const { return Layout::offset(i, j, ld); }
+
+        /// @brief true if the storage holds exactly the logical elements, without padding.
+        bool isDense() const { return values.size() == rows * cols; }
+
+        /**
+         * @brief Invokes f(offset, length) for every contiguous run of logical elements.
+         *
+         * Padding is never visited, so operations such as integer division
+         * can't trap on it. A dense tensor is reported as a single run.
+         */
+        template<typename F>
+        void forEachRun(F&& f) const
+        {
+            if (isDense())
+            {
+                f(size_t{0}, values.size());
+                return;
+            }
+            Layout::forEachRun(rows, cols, ld, 0, Layout::lineCount(rows, cols), f);
+        }
+
+        /// @brief Zero tensor for a derived result, padded (see padded()) if this tensor is.
+        Tensor<T, Layout> resultLike(size_t resultRows, size_t resultCols) const
+        {
+            if (ld != Layout::defaultLd(rows, cols))
+                return padded(resultRows, resultCols);
+            return Tensor<T, Layout>(resultRows, resultCols);
+        }
+
+        /// @brief Storage pointer for begin()/end(), which require unpadded storage.
+        T* contiguousData()
+        {
+            if (!isDense())
+                TENSOR_THROW(std::logic_error, "Tensor storage is padded; iterate by row or column instead");
+            markWritten();
+            return values.data();
+        }
+
+        /// @copydoc contiguousData()
+        const T* contiguousData() const
+        {
+            if (!isDense())
+                TENSOR_THROW(std::logic_error, "Tensor storage is padded; iterate by row or column instead");
+            return values.data();
+        }
+
+        /// @brief Order-independent hash term of one element, summed by trackedHash().
+        uint64_t hashTerm(size_t i, size_t j, const T& value) const
+        {
+            static_assert(sizeof(T) <= sizeof(uint64_t), "Hashing requires element types of at most 8 bytes");
+            uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(T));
+            return detail::ContentHasher::mixWord(bits, (i * cols) + j);
+        }
+
+        /// @brief out[0, n) = src[0, n) * alpha, vectorized when T supports it.
+        static void scaleRun(const T* src, T alpha, T* out, size_t n)
+        {
+            if constexpr (detail::simd::VecOps<T>::hasMul)
+                detail::simd::scale(src, alpha, out, n, false);
+            else
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = src[i] * alpha;
+        }
+
+        /// @brief Elements in row-major logical order.
+        std::vector<T> flatten() const
+        {
+            std::vector<T> out;
+            out.reserve(rows * cols);
+            for (size_t i = 0; i < rows; ++i)
+                for (size_t j = 0; j < cols; ++j)
+                    out.push_back(values[index(i, j)]);
+            return out;
+        }
+
+        /**
+         * @brief Maximum ULP distance to another tensor, stopping once it exceeds limit.
+         */
+        uint64_t ulpScan(const Tensor<T, Layout>& otherTensor, uint64_t limit) const
+        {
+            static_assert(std::is_floating_point<T>::value, "ULP distance requires a floating point type");
+            if(rows != otherTensor.rows || cols != otherTensor.cols)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            uint64_t best = 0;
+            allRunPairs(otherTensor, [&](size_t offset, size_t otherOffset, size_t length)
+            {
+                best = std::max(best, detail::simd::maxUlpDistance(values.data() + offset, otherTensor.values.data() + otherOffset,
+                                                                   length, limit));
+                return best <= limit;
+            });
+            return best;
+        }
+
+        /**
+         * @brief true if f(offset, length) holds for every run; stops calling f after the first false.
+         */
+        template<typename F>
+        bool allRuns(F&& f) const
+        {
+            bool ok = true;
+            forEachRun([&](size_t offset, size_t length)
+            {
+                ok = ok && f(offset, length);
+            });
+            return ok;
+        }
+
+        /**
+         * @brief forEachRun() split across the thread pool for large tensors.
+         *
+         * Below config::parallelThreshold elements this is forEachRun(). A dense
+         * tensor is cut into cache-line-aligned chunks of its storage, otherwise
+         * whole lines are distributed. f must be safe to call concurrently on
+         * disjoint runs; call it on the tensor being written so the chunks are
+         * aligned to its storage.
+         */
+        template<typename F>
+        void forEachRunParallel(F&& f) const
+        {
+            if ((rows * cols) < config::parallelThreshold)
+            {
+                forEachRun(f);
+                return;
+            }
+            if (isDense())
+            {
+                detail::parallelChunks(values.data(), values.size(), f);
+                return;
+            }
+            detail::parallelFor(Layout::lineCount(rows, cols), 1, [&](size_t firstLine, size_t lastLine)
+            {
+                Layout::forEachRun(rows, cols, ld, firstLine, lastLine, f);
+            });
+        }
+
+        /**
+         * @brief Invokes f(offset, otherOffset, length) for the runs of lines [firstLine, lastLine).
+         *
+         * Pairs each run of this tensor with the run holding the same logical
+         * elements in other, which may have a different leading dimension.
+         */
+        template<typename U, typename F>
+        void pairLines(const Tensor<U, Layout>& other, size_t firstLine, size_t lastLine, F&& f) const
+        {
+            if (ld == other.ld)
+            {
+                Layout::forEachRun(rows, cols, ld, firstLine, lastLine, [&](size_t offset, size_t length)
+                {
+                    f(offset, offset, length);
+                });
+                return;
+            }
+            thread_local std::vector<size_t> otherOffsets;
+            for (size_t line = firstLine; line < lastLine; ++line)
+            {
+                otherOffsets.clear();
+                Layout::forEachRun(rows, cols, other.ld, line, line + 1, [&](size_t offset, size_t)
+                {
+                    otherOffsets.push_back(offset);
+                });
+                size_t run = 0;
+                Layout::forEachRun(rows, cols, ld, line, line + 1, [&](size_t offset, size_t length)
+                {
+                    f(offset, otherOffsets[run++], length);
+                });
+            }
+        }
+
+        /**
+         * @brief forEachRun() over this tensor and a same-shaped one, f(offset, otherOffset, length).
+         */
+        template<typename U, typename F>
+        void forEachRunPair(const Tensor<U, Layout>& other, F&& f) const
+        {
+            if (ld == other.ld)
+                forEachRun([&](size_t offset, size_t length) { f(offset, offset, length); });
+            else
+                pairLines(other, 0, Layout::lineCount(rows, cols), f);
+        }
+
+        /**
+         * @brief true if f(offset, otherOffset, length) holds for every run pair; stops after the first false.
+         */
+        template<typename U, typename F>
+        bool allRunPairs(const Tensor<U, Layout>& other, F&& f) const
+        {
+            bool ok = true;
+            forEachRunPair(other, [&](size_t offset, size_t otherOffset, size_t length)
+            {
+                ok = ok && f(offset, otherOffset, length);
+            });
+            return ok;
+        }
+
+        /**
+         * @brief forEachRunParallel() over this tensor and a same-shaped one, f(offset, otherOffset, length).
+         */
+        template<typename U, typename F>
+        void forEachRunPairParallel(const Tensor<U, Layout>& other, F&& f) const
+        {
+            if (ld == other.ld)
+            {
+                forEachRunParallel([&](size_t offset, size_t length) { f(offset, offset, length); });
+                return;
+            }
+            const size_t lines = Layout::lineCount(rows, cols);
+            if ((rows * cols) < config::parallelThreshold)
+            {
+                pairLines(other, 0, lines, f);
+                return;
+            }
+            detail::parallelFor(lines, 1, [&](size_t firstLine, size_t lastLine)
+            {
+                pairLines(other, firstLine, lastLine, f);
+            });
+        }
+
+        /**
+         * @brief Sums runValue(offset, otherOffset, length) over all run pairs, in parallel for large tensors.
+         *
+         * Dense tensors sharing a leading dimension are partitioned by element,
+         * others by whole lines; see detail::parallelReduce() for the
+         * config::deterministic guarantees.
+         */
+        template<typename U, typename F>
+        T reduceRunPairs(const Tensor<U, Layout>& other, F&& runValue) const
+        {
+            const bool parallel = (rows * cols) >= config::parallelThreshold;
+            if (isDense() && ld == other.ld)
+                return detail::parallelReduce<T>(values.size(), config::reductionBlock, parallel,
+                                                 [&](size_t first, size_t last) { return runValue(first, first, last - first); });
+
+            const size_t lines = Layout::lineCount(rows, cols);
+            const size_t perLine = std::max<size_t>(1, (rows * cols) / std::max<size_t>(1, lines));
+            return detail::parallelReduce<T>(lines, config::reductionBlock / perLine, parallel,
+                                             [&](size_t firstLine, size_t lastLine)
+            {
+                T partial = T{};
+                pairLines(other, firstLine, lastLine, [&](size_t offset, size_t otherOffset, size_t length)
+                {
+                    partial += runValue(offset, otherOffset, length);
+                });
+                return partial;
+            });
+        }
+
+        /**
+         * @brief Sums runValue(offset, length) over all runs, see reduceRunPairs().
+         */
+        template<typename F>
+        T reduceRuns(F&& runValue) const
+        {
+            return reduceRunPairs(*this, [&](size_t offset, size_t, size_t length) { return runValue(offset, length); });
+        }
+
+        /**
+         * @brief result(i, j) = source(i, j) * d(i, i) (byRow) or source(i, j) * d(j, j), for a diagonal d.
+         *
+         * Lines past the end of d's diagonal are left zero.
+         */
+        template<bool byRow>
+        static void scaleByDiagonal(const Tensor<T, Layout>& source, const Tensor<T, Layout>& d, Tensor<T, Layout>& result)
+        {
+            const size_t count = std::min(d.rows, d.cols);
+            std::vector<T> scale(count);
+            for (size_t k = 0; k < count; ++k)
+                scale[k] = d.values[d.index(k, k)];
+            const size_t rowEnd = byRow ? count : result.rows;
+            const size_t colEnd = byRow ? result.cols : count;
+            if constexpr (std::is_same<Layout, ColMajor>::value)
+            {
+                for (size_t j = 0; j < colEnd; ++j)
+                {
+                    const T* src = source.values.data() + source.index(0, j);
+                    T* out = result.values.data() + result.index(0, j);
+                    if constexpr (byRow)
+                        for (size_t i = 0; i < rowEnd; ++i)
+                            out[i] = src[i] * scale[i];
+                    else
+                        scaleRun(src, scale[j], out, rowEnd);
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < rowEnd; ++i)
+                    for (size_t j = 0; j < colEnd; ++j)
+                        result.values[result.index(i, j)] = source.values[source.index(i, j)] * (byRow ? scale[i] : scale[j]);
+            }
+        }
+
+        /**
+         * @brief Adds (*this) * other to result, skipping the blocks a triangular operand has no elements in.
+         *
+         * The triangular dimension is cut into blocks; each block of C is the
+         * product of the slices of both operands it can reach, about half the
+         * multiply-adds of the full product once there are many blocks.
+         * Blocked storage can't be sliced at arbitrary lines and isn't handled.
+         *
+         * @return false if neither operand is triangular along a long enough dimension.
+         */
+        bool triangularProduct(const Tensor<T, Layout>& other, Tensor<T, Layout>& result, uint8_t a, uint8_t b) const
+        {
+            if constexpr (!std::is_same<Layout, RowMajor>::value && !std::is_same<Layout, ColMajor>::value)
+                return false;
+            else
+            {
+                constexpr size_t block = 128;
+                const size_t M = rows, N = other.cols, K = cols;
+                auto product = [&](size_t i0, size_t i1, size_t j0, size_t j1, size_t k0, size_t k1)
+                {
+                    if (i0 < i1 && j0 < j1 && k0 < k1)
+                        Layout::gemm(i1 - i0, j1 - j0, k1 - k0, values.data() + index(i0, k0), ld,
+                                     other.values.data() + other.index(k0, j0), other.ld,
+                                     result.values.data() + result.index(i0, j0), result.ld);
+                };
+                if ((a & (upperBit | lowerBit)) && M >= 2 * block)
+                {
+                    for (size_t i0 = 0; i0 < M; i0 += block)
+                    {
+                        const size_t i1 = std::min(M, i0 + block);
+                        if (a & upperBit)
+                            product(i0, i1, 0, N, i0, K);
+                        else
+                            product(i0, i1, 0, N, 0, std::min(i1, K));
+                    }
+                    return true;
+                }
+                if ((b & (upperBit | lowerBit)) && N >= 2 * block)
+                {
+                    for (size_t j0 = 0; j0 < N; j0 += block)
+                    {
+                        const size_t j1 = std::min(N, j0 + block);
+                        if (b & upperBit)
+                            product(0, M, j0, j1, 0, std::min(j1, K));
+                        else
+                            product(0, M, j0, j1, j0, K);
+                    }
+                    return true;
+                }
+                return false;
+            }
+        }
+
+        /**
+         * @brief Writes (*this) * other into the zero result when an operand's structure allows a shortcut.
+         *
+         * A zero operand leaves the result zero, an identity copies the
+         * other operand, a diagonal one scales its lines, all in O(n^2); a
+         * triangular one halves the product (see triangularProduct()).
+         * Only recorded structure counts, so a general product pays one test.
+         *
+         * @return false if the general product is still needed.
+         */
+        bool multiplyStructured(const Tensor<T, Layout>& other, Tensor<T, Layout>& result) const
+        {
+            if (!config::structuredProducts)
+                return false;
+            const uint8_t a = recordedStructure();
+            const uint8_t b = other.recordedStructure();
+            if ((a | b) & zeroBit)
+                return true;
+            if (a & identityBit)
+            {
+                result.forEachRunPair(other, [&](size_t offset, size_t otherOffset, size_t length)
+                {
+                    std::copy_n(other.values.data() + otherOffset, length, result.values.data() + offset);
+                });
+                return true;
+            }
+            if (b & identityBit)
+            {
+                result.forEachRunPair(*this, [&](size_t offset, size_t otherOffset, size_t length)
+                {
+                    std::copy_n(values.data() + otherOffset, length, result.values.data() + offset);
+                });
+                return true;
+            }
+            if (a & diagonalBit)
+            {
+                scaleByDiagonal<true>(other, *this, result);
+                return true;
+            }
+            if (b & diagonalBit)
+            {
+                scaleByDiagonal<false>(*this, other, result);
+                return true;
+            }
+            return triangularProduct(other, result, a, b);
+        }
+
+    public:
+        /// @brief Storage order policy of this tensor.
+        using layout_type = Layout;
+
+        /**
+         * @brief Constructs a Tensor of specified dimensions, initialized with zeros.
+         * 
+         * @param rows Number of rows.
+         * @param cols Number of columns.
+         * @throws std::invalid_argument if either dimension is zero.
+         */
+        Tensor(size_t rows, size_t cols)
+            : rows(rows), cols(cols),
+              ld(config::padLeadingDimension ? Layout::paddedLd(rows, cols, sizeof(T)) : Layout::defaultLd(rows, cols)),
+              values(Layout::storageSize(rows, cols, ld), T{})
+        {
+            if (rows == 0 || cols == 0)
+                TENSOR_THROW(std::invalid_argument, "Size can't be 0");
+        }
+
+        /**
+         * @brief Constructs a zero Tensor with an explicit leading dimension.
+         * 
+         * Every kernel honors the leading dimension; padding is never read or
+         * written. Pass the ld of another tensor to make element-wise operations
+         * between them run on shared offsets.
+         * 
+         * @param rows Number of rows.
+         * @param cols Number of columns.
+         * @param leadingDim Distance between storage lines (rows for RowMajor,
+         *        columns for ColMajor, tile rows in elements for Blocked).
+         * @throws std::invalid_argument if a dimension is zero or the leading dimension can't hold a line.
+         */
+        Tensor(size_t rows, size_t cols, LeadingDim leadingDim)
+            : rows(rows), cols(cols), ld(leadingDim.value)
+        {
+            if (rows == 0 || cols == 0)
+                TENSOR_THROW(std::invalid_argument, "Size can't be 0");
+            if (!Layout::validLd(rows, cols, ld))
+                TENSOR_THROW(std::invalid_argument, "Leading dimension too small for the shape");
+            values.assign(Layout::storageSize(rows, cols, ld), T{});
+        }
+
+        /**
+         * @brief Creates a zero tensor whose leading dimension avoids cache-set aliasing.
+         * 
+         * Line strides that are multiples of 512 bytes (e.g. 1024 floats) get one
+         * cache line of padding, whatever config::padLeadingDimension says.
+         * 
+         * @param rows Number of rows.
+         * @param cols Number of columns.
+         * @return Zero tensor with Layout::paddedLd().
+         * @throws std::invalid_argument if either dimension is zero.
+         */
+        static Tensor<T, Layout> padded(size_t rows, size_t cols)
+        {
+            return Tensor<T, Layout>(rows, cols, LeadingDim{Layout::paddedLd(rows, cols, sizeof(T))});
+        }
+
+        /**
+         * @brief Constructs a Tensor that adopts an existing buffer without copying it.
+         * 
+         * The elements must be in this layout's storage order, i.e. row by row
+         * for RowMajor, column by column for ColMajor, and tile by tile with
+         * zero padding for Blocked; the expected length is storageSize().
+         * 
+         * @param rows Number of rows.
+         * @param cols Number of columns.
+         * @param elements Storage to take over; left empty.
+         * @throws std::invalid_argument if either dimension is zero.
+         * @throws std::runtime_error if elements.size() != storageSize(rows, cols).
+         */
+        Tensor(size_t rows, size_t cols, std::vector<T>&& elements)
+            : rows(rows), cols(cols), ld(Layout::defaultLd(rows, cols))
+        {
+            if (rows == 0 || cols == 0)
+                TENSOR_THROW(std::invalid_argument, "Size can't be 0");
+            if (elements.size() != Layout::storageSize(rows, cols, ld))
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+            values = std::move(elements);
+        }
+
+        /**
+         * @brief Constructs a Tensor by copying a raw buffer in storage order.
+         * 
+         * @param rows Number of rows.
+         * @param cols Number of columns.
+         * @param elements Elements laid out as for the adopting constructor.
+         * @param count Length of elements; must equal storageSize(rows, cols).
+         * @throws std::invalid_argument if either dimension is zero or elements is null.
+         * @throws std::runtime_error if count != storageSize(rows, cols).
+         */
+        Tensor(size_t rows, size_t cols, const T* elements, size_t count)
+            : rows(rows), cols(cols), ld(Layout::defaultLd(rows, cols))
+        {
+            if (rows == 0 || cols == 0)
+                TENSOR_THROW(std::invalid_argument, "Size can't be 0");
+            if (elements == nullptr)
+                TENSOR_THROW(std::invalid_argument, "Elements can't be null");
+            if (count != Layout::storageSize(rows, cols, ld))
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+            values.assign(elements, elements + count);
+        }
+
+        /// @brief A null buffer is rejected at compile time; see Tensor(size_t, size_t, const T*, size_t).
+        Tensor(size_t rows, size_t cols, std::nullptr_t, size_t count) = delete;
+
+        /**
+         * @brief Constructs a Tensor from a flat list in storage order, e.g. Tensor<int>(2, 2, {1, 2, 3, 4}).
+         * 
+         * Also makes a braced last argument such as {0} resolve here rather
+         * than be ambiguous between the LeadingDim and std::vector overloads.
+         * 
+         * @param rows Number of rows.
+         * @param cols Number of columns.
+         * @param elements storageSize(rows, cols) elements.
+         * @throws std::invalid_argument if either dimension is zero.
+         * @throws std::runtime_error if elements.size() != storageSize(rows, cols).
+         */
+        Tensor(size_t rows, size_t cols, std::initializer_list<T> elements)
+            : Tensor(rows, cols, elements.begin(), elements.size())
+        {
+        }
+
+#if defined(__cpp_lib_span)
+        /**
+         * @brief Constructs a Tensor by copying a span in storage order, see Tensor(size_t, size_t, const T*, size_t).
+         * 
+         * @param rows Number of rows.
+         * @param cols Number of columns.
+         * @param elements storageSize(rows, cols) elements.
+         * @throws std::invalid_argument if either dimension is zero.
+         * @throws std::runtime_error if elements.size() != storageSize(rows, cols).
+         */
+        Tensor(size_t rows, size_t cols, std::span<const T> elements)
+            : Tensor(rows, cols, elements.data(), elements.size())
+        {
+        }
+#endif
+
+        /**
+         * @brief Constructs a Tensor from nested lists, one inner list per row.
+         * 
+         * Tensor<int> m{{1, 2}, {3, 4}} builds a 2 x 2 matrix.
+         * 
+         * @param rowLists The rows, all of the same length.
+         * @throws std::invalid_argument if there are no rows or the rows are empty.
+         * @throws std::runtime_error if the rows differ in length.
+         */
+        Tensor(std::initializer_list<std::initializer_list<T>> rowLists)
+            : Tensor(rowLists.size(), rowLists.size() == 0 ? 0 : rowLists.begin()->size())
+        {
+            size_t i = 0;
+            for (const auto& rowList : rowLists)
+            {
+                if (rowList.size() != cols)
+                    TENSOR_THROW(std::runtime_error, "Size mismatch");
+                size_t j = 0;
+                for (const T& value : rowList)
+                    values[index(i, j++)] = value;
+                ++i;
+            }
+        }
+
+        /**
+         * @brief Number of storage elements a tensor of the given shape uses, padding included.
+         * 
+         * @param rows Number of rows.
+         * @param cols Number of columns.
+         * @return Required length of a buffer passed to the buffer constructors.
+         */
+        static size_t storageSize(size_t rows, size_t cols)
+        {
+            return Layout::storageSize(rows, cols, Layout::defaultLd(rows, cols));
+        }
+
+        /**
+         * @brief Moves the storage out, in storage order, without copying.
+         * 
+         * The tensor is left as an empty 0 x 0 tensor that may only be
+         * assigned to or destroyed.
+         * 
+         * @return The storage buffer (see storageSize()).
+         */
+        std::vector<T> release()
+        {
+            std::vector<T> out = std::move(values);
+            makeEmpty();
+            return out;
+        }
+
+        /// @brief Copies shape, storage and cached state.
+        Tensor(const Tensor&) = default;
+
+        /// @brief Copy assignment.
+        Tensor& operator=(const Tensor&) = default;
+
+        /**
+         * @brief Takes over the storage without allocating.
+         *
+         * The source is left as an empty 0 x 0 tensor, as after release().
+         */
+        Tensor(Tensor&& other) noexcept
+            : rows(other.rows), cols(other.cols), ld(other.ld), values(std::move(other.values)),
+              hashTracking(other.hashTracking), stale(other.stale), trackedSum(other.trackedSum),
+              versionStamp(other.versionStamp), structureBits(other.structureBits), writeLog(std::move(other.writeLog))
+        {
+            other.makeEmpty();
+        }
+
+        /// @brief Move assignment, see the move constructor.
+        Tensor& operator=(Tensor&& other) noexcept
+        {
+            if (this != &other)
+            {
+                rows = other.rows;
+                cols = other.cols;
+                ld = other.ld;
+                values = std::move(other.values);
+                hashTracking = other.hashTracking;
+                stale = other.stale;
+                trackedSum = other.trackedSum;
+                versionStamp = other.versionStamp;
+                structureBits = other.structureBits;
+                writeLog = std::move(other.writeLog);
+                other.makeEmpty();
+            }
+            return *this;
+        }
+
+        /// @brief Default destructor.
+        ~Tensor() = default;
+
+        /**
+         * @brief Creates an identity matrix.
+         * 
+         * @param n Number of rows and columns.
+         * @return n x n tensor with ones on the diagonal.
+         * @throws std::invalid_argument if n is zero.
+         */
+        static Tensor<T, Layout> eye(size_t n)
+        {
+            Tensor<T, Layout> result(n, n);
+            for (size_t i = 0; i < n; ++i)
+                result.values[result.index(i, i)] = T{1};
+            result.setStructure(diagonalBit | identityBit | upperBit | lowerBit);
+            return result;
+        }
+
+        /**
+         * @brief Creates a square diagonal matrix.
+         * 
+         * Products with it scale lines in O(n^2) instead of multiplying.
+         * 
+         * @param diagonal Diagonal elements, top left first.
+         * @return diagonal.size() x diagonal.size() tensor.
+         * @throws std::invalid_argument if diagonal is empty.
+         */
+        static Tensor<T, Layout> diag(const std::vector<T>& diagonal)
+        {
+            Tensor<T, Layout> result(diagonal.size(), diagonal.size());
+            for (size_t i = 0; i < diagonal.size(); ++i)
+                result.values[result.index(i, i)] = diagonal[i];
+            uint8_t bits = diagonalBit | upperBit | lowerBit;
+            if (std::all_of(diagonal.begin(), diagonal.end(), [](const T& d) { return d == T{1}; }))
+                bits |= identityBit;
+            if (std::all_of(diagonal.begin(), diagonal.end(), [](const T& d) { return d == T{}; }))
+                bits |= zeroBit;
+            result.setStructure(bits);
+            return result;
+        }
+
+        /**
+         * @brief Scans the elements once and records their structure until the next write.
+         * 
+         * The structure queries then take it in O(1) instead of scanning on
+         * every call, and with config::structuredProducts on, products use it
+         * for their shortcuts. Factories such as eye() and diag() record it
+         * themselves. Like version(), writes through references kept from
+         * operator() across a call go unnoticed, so don't hold them.
+         */
+        void detectStructure()
+        {
+            setStructure(scanStructure());
+        }
+
+        /// @brief true if every element is zero; see detectStructure().
+        bool isZero() const { return knownStructure() & zeroBit; }
+
+        /// @brief true if the tensor is a square identity matrix; see detectStructure().
+        bool isIdentity() const { return knownStructure() & identityBit; }
+
+        /// @brief true if every element off the main diagonal is zero; see detectStructure().
+        bool isDiagonal() const { return knownStructure() & diagonalBit; }
+
+        /// @brief true if every element below the main diagonal is zero; see detectStructure().
+        bool isUpperTriangular() const { return knownStructure() & upperBit; }
+
+        /// @brief true if every element above the main diagonal is zero; see detectStructure().
+        bool isLowerTriangular() const { return knownStructure() & lowerBit; }
+
+        /**
+         * @brief Accesses (modifiable) the element at position (i, j).
+         * 
+         * Counts as a write of (i, j) even when the reference is only read;
+         * read a non-const tensor through std::as_const(t)(i, j) to keep its
+         * version() and write log.
+         * 
+         * @param i Row index.
+         * @param j Column index.
+         * @return Reference to the element.
+         * @throws std::out_of_range on invalid indices.
+         */
+        T& operator()(size_t i, size_t j)
+        {
+            if (i >= rows || j >= cols)
+                TENSOR_THROW(std::out_of_range, "Index out of range: (" + std::to_string(i) + ", " + std::to_string(j) + ")");
+            markWritten(i, j);
+            return values[index(i, j)];
+        }
+
+        /**
+         * @brief Accesses (read-only) the element at position (i, j).
+         * 
+         * @param i Row index.
+         * @param j Column index.
+         * @return Const reference to the element.
+         * @throws std::out_of_range on invalid indices.
+         */
+        const T& operator()(size_t i, size_t j) const
+        {
+            if (i >= rows || j >= cols)
+                TENSOR_THROW(std::out_of_range, "Index out of range: (" + std::to_string(i) + ", " + std::to_string(j) + ")");
+            return values[index(i, j)];
+        }
+
+        /**
+         * @brief Checks equality with another tensor.
+         * 
+         * @param otherTensor Tensor to compare.
+         * @return true if dimensions and elements match.
+         */
+        bool operator==(const Tensor<T, Layout>& otherTensor) const
+        {
+            if (rows != otherTensor.rows || cols != otherTensor.cols)
+                return false;
+            if (isDense() && ld == otherTensor.ld)
+                return values == otherTensor.values;
+
+            return allRunPairs(otherTensor, [&](size_t offset, size_t otherOffset, size_t length)
+            {
+                return std::equal(values.begin() + offset, values.begin() + offset + length,
+                                  otherTensor.values.begin() + otherOffset);
+            });
+        }
+
+        /**
+         * @brief Checks inequality with another tensor.
+         * 
+         * @param otherTensor Tensor to compare.
+         * @return true if tensors differ.
+         */
+        bool operator!=(const Tensor<T, Layout>& otherTensor) const
+        {
+            return !(*this == otherTensor);
+        }
+
+        /**
+         * @brief Checks that all elements are within tolerance of another tensor.
+         * 
+         * Element pairs are close when |a - b| <= atol + rtol * |b| (numpy
+         * semantics). Floating point values is compared with vector kernels and
+         * the scan stops at the first element out of tolerance.
+         * 
+         * @param otherTensor Tensor to compare (the reference values).
+         * @param rtol Relative tolerance.
+         * @param atol Absolute tolerance.
+         * @return true if dimensions match and every element is close; false for any NaN.
+         */
+        bool allClose(const Tensor<T, Layout>& otherTensor, double rtol = 1e-5, double atol = 1e-8) const
+        {
+            if (rows != otherTensor.rows || cols != otherTensor.cols)
+                return false;
+            return allRunPairs(otherTensor, [&](size_t offset, size_t otherOffset, size_t length)
+            {
+                return detail::simd::allClose(values.data() + offset, otherTensor.values.data() + otherOffset, length, rtol, atol);
+            });
+        }
+
+        /**
+         * @brief Largest absolute element-wise difference to another tensor.
+         * 
+         * @param otherTensor Tensor to compare.
+         * @return max |a - b|, or NaN if any difference is NaN.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        T maxAbsDiff(const Tensor<T, Layout>& otherTensor) const
+        {
+            static_assert(std::is_floating_point<T>::value, "maxAbsDiff requires a floating point type");
+            if(rows != otherTensor.rows || cols != otherTensor.cols)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            T best = T{0};
+            allRunPairs(otherTensor, [&](size_t offset, size_t otherOffset, size_t length)
+            {
+                const T runMax = detail::simd::maxAbsDiff(values.data() + offset, otherTensor.values.data() + otherOffset, length);
+                best = std::isnan(runMax) ? runMax : std::max(best, runMax);
+                return !std::isnan(best);
+            });
+            return best;
+        }
+
+        /**
+         * @brief Largest distance in units in the last place to another tensor.
+         * 
+         * @param otherTensor Tensor to compare.
+         * @return Maximum ULP distance; UINT64_MAX if any element is NaN.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        uint64_t maxUlpDistance(const Tensor<T, Layout>& otherTensor) const
+        {
+            return ulpScan(otherTensor, std::numeric_limits<uint64_t>::max());
+        }
+
+        /**
+         * @brief Checks that every element is at most maxUlps representable values away.
+         * 
+         * Stops scanning as soon as the bound is exceeded.
+         * 
+         * @param otherTensor Tensor to compare.
+         * @param maxUlps Allowed distance in units in the last place.
+         * @return true if dimensions match and all elements are within maxUlps.
+         */
+        bool withinUlps(const Tensor<T, Layout>& otherTensor, uint64_t maxUlps) const
+        {
+            if (rows != otherTensor.rows || cols != otherTensor.cols)
+                return false;
+            return ulpScan(otherTensor, maxUlps) <= maxUlps;
+        }
+
+        /**
+         * @brief Applies a comparison element-wise.
+         * 
+         * @tparam Compare A callable predicate (e.g., std::less).
+         * @param otherTensor The other tensor.
+         * @param cmp Predicate applied as cmp(this(i, j), other(i, j)).
+         * @return Mask with 1 where the predicate holds.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        template<typename Compare>
+        Mask<Layout> compare(const Tensor<T, Layout>& otherTensor, Compare cmp) const
+        {
+            if(rows != otherTensor.rows || cols != otherTensor.cols)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            Mask<Layout> result(rows, cols, LeadingDim{ld});
+            forEachRunPair(otherTensor, [&](size_t offset, size_t otherOffset, size_t length)
+            {
+                const T* a = values.data() + offset;
+                const T* b = otherTensor.values.data() + otherOffset;
+                std::uint8_t* out = result.values.data() + offset;
+                for (size_t i = 0; i < length; ++i)
+                    out[i] = static_cast<std::uint8_t>(cmp(a[i], b[i]));
+            });
+            return result;
+        }
+
+        /**
+         * @brief Element-wise tolerance test, see allClose().
+         * 
+         * @param otherTensor Tensor to compare (the reference values).
+         * @param rtol Relative tolerance.
+         * @param atol Absolute tolerance.
+         * @return Mask with 1 where the elements are close.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        Mask<Layout> isClose(const Tensor<T, Layout>& otherTensor, double rtol = 1e-5, double atol = 1e-8) const
+        {
+            return compare(otherTensor, [rtol, atol](T a, T b){ return detail::simd::isClose(a, b, rtol, atol); });
+        }
+
+        /**
+         * @brief Performs an element-wise operation with another tensor.
+         * 
+         * std::plus, std::minus and std::multiplies on float, double and
+         * 32/64-bit integers run on hand-vectorized kernels; any other
+         * callable goes through std::transform. Tensors of at least
+         * config::parallelThreshold elements are processed by the thread pool.
+         * 
+         * @tparam BinaryOp A callable binary operator (e.g., std::plus).
+         * @param otherTensor The other tensor.
+         * @param op Binary operation to apply.
+         * @return Resulting tensor.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        template<typename BinaryOp>
+        inline Tensor<T, Layout> elementWiseOp(const Tensor<T, Layout>& otherTensor, BinaryOp op) const
+        {
+            if(rows != otherTensor.rows || cols != otherTensor.cols)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            // The result shares this tensor's leading dimension, so only the other operand's offsets can differ.
+            Tensor<T, Layout> result(rows, cols, LeadingDim{ld});
+            const bool nonTemporal = detail::simd::useNonTemporal(result.values.size() * sizeof(T));
+            result.forEachRunPairParallel(otherTensor, [&](size_t offset, size_t otherOffset, size_t length)
+            {
+                if constexpr (detail::simd::hasKernel<BinaryOp, T>())
+                    detail::simd::binary<BinaryOp>(values.data() + offset, otherTensor.values.data() + otherOffset,
+                                                   result.values.data() + offset, length, nonTemporal);
+                else
+                    std::transform(values.begin() + offset, values.begin() + offset + length,
+                                   otherTensor.values.begin() + otherOffset, result.values.begin() + offset, op);
+            });
+            return result;
+        }
+
+        /**
+         * @brief Element-wise addition with another tensor.
+         * 
+         * @param otherTensor The tensor to add.
+         * @return Sum tensor.
+         */
+        Tensor<T, Layout> operator+(const Tensor<T, Layout>&& otherTensor) const
+        {
+            return elementWiseOp(otherTensor, std::plus<T>());
+        }
+
+        /**
+         * @brief Element-wise subtraction with another tensor.
+         * 
+         * @param otherTensor The tensor to subtract.
+         * @return Difference tensor.
+         */
+        Tensor<T, Layout> operator-(const Tensor<T, Layout>&& otherTensor) const
+        {
+            return elementWiseOp(otherTensor, std::minus<T>());
+        }
+
+        /**
+         * @brief Element-wise (Hadamard) product with another tensor.
+         * 
+         * @param otherTensor The tensor to multiply element by element.
+         * @return Product tensor.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        Tensor<T, Layout> hadamard(const Tensor<T, Layout>& otherTensor) const
+        {
+            return elementWiseOp(otherTensor, std::multiplies<T>());
+        }
+
+        /**
+         * @brief Sums all elements.
+         * 
+         * Large tensors are reduced in parallel; set config::deterministic for
+         * results that don't depend on the thread count.
+         * 
+         * @return Sum of the elements.
+         */
+        T sum() const
+        {
+            return reduceRuns([&](size_t offset, size_t length)
+            {
+                return detail::simd::sum(values.data() + offset, length);
+            });
+        }
+
+        /**
+         * @brief Inner (Frobenius) product with another tensor.
+         * 
+         * Reduced like sum().
+         * 
+         * @param otherTensor Tensor of the same shape.
+         * @return Sum of the element-wise products.
+         * @throws std::runtime_error if dimensions mismatch.
+         */
+        T dot(const Tensor<T, Layout>& otherTensor) const
+        {
+            if(rows != otherTensor.rows || cols != otherTensor.cols)
+                TENSOR_THROW(std::runtime_error, "Size mismatch");
+
+            return reduceRunPairs(otherTensor, [&](size_t offset, size_t otherOffset, size_t length)
+            {
+                return detail::simd::dot(values.data() + offset, otherTensor.values.data() + otherOffset, length);
+            });
+        }
+
+        /**
+         * @brief Frobenius norm (Euclidean norm for vectors).
+         * 
+         * @return sqrt(dot(*this)).
+         */
+        T norm() const
+        {
+            static_assert(std::is_floating_point<T>::value, "norm requires a floating point type");
+            return std::sqrt(dot(*this));
+        }
+
+        /**
+         * @brief Scalar multiplication.
+         * 
+         * @param scalar Value to multiply each element.
+         * @return Scaled tensor.
+         */
+        Tensor<T, Layout> operator*(const T& scalar) const
+        {
+            Tensor<T, Layout> result(rows, cols, LeadingDim{ld});
+            const bool nonTemporal = detail::simd::useNonTemporal(result.values.size() * sizeof(T));
+            result.forEachRunParallel([&](size_t offset, size_t length)
+            {
+                if constexpr (detail::simd::VecOps<T>::hasMul)
+                    detail::simd::scale(values.data() + offset, scalar, result.values.data() + offset, length, nonTemporal);
+                else
+                    std::transform(values.begin() + offset, values.begin() + offset + length, result.values.begin() + offset,
+                                   [&scalar](const T& val){ return val * scalar; });
+            });
+            return result;
+        }
+
+        /**
+         * @brief Matrix multiplication with another tensor.
+         * 
+         * Dispatches to the layout's kernel, so no operand is transposed or
+         * converted on the way. A zero, identity or diagonal operand makes
+         * the product O(n^2) and a triangular one halves it when
+         * config::structuredProducts is on; see detectStructure().
+         * 
+         * @param otherTensor The tensor to multiply with.
+         * @return Product tensor.
+         * @throws std::runtime_error if dimensions are incompatible.
+         */
+        Tensor<T, Layout> operator*(const Tensor<T, Layout>& otherTensor) const
+        {
+            if(cols != otherTensor.rows)
+                TENSOR_THROW(std::runtime_error, "Matrix dimensions incompatible for multiplication");
+
+            Tensor<T, Layout> result = resultLike(rows, otherTensor.cols);
+            if (multiplyStructured(otherTensor, result))
+                return result;
+            Layout::gemm(rows, otherTensor.cols, cols,
+                         values.data(), ld, otherTensor.values.data(), otherTensor.ld,
+                         result.values.data(), result.ld);
+            return result;
+        }
+
+        /**
+         * @brief Computes (*this)^T * otherTensor without forming the transpose.
+         * 
+         * The transposed operand is read in place by the packing routines.
+         * For tall operands (rows much larger than both column counts, e.g. a
+         * Gram matrix X^T * X) the long inner dimension is split over the
+         * thread pool and the partial products are summed.
+         * 
+         * @param otherTensor Right operand, with as many rows as this tensor.
+         * @return colCount() x otherTensor.colCount() product.
+         * @throws std::runtime_error if the row counts differ.
+         */
+        Tensor<T, Layout> transposeMultiply(const Tensor<T, Layout>& otherTensor) const
+        {
+            if(rows != otherTensor.rows)
+                TENSOR_THROW(std::runtime_error, "Matrix dimensions incompatible for multiplication");
+
+            if constexpr (std::is_same<Layout, RowMajor>::value || std::is_same<Layout, ColMajor>::value)
+            {
+                Tensor<T, Layout> result = resultLike(cols, otherTensor.cols);
+                // Both storages read line by line: this one across its lines, the other along them.
+                const detail::Strided<T> across{values.data(), 1, ld};
+                const detail::Strided<T> along{otherTensor.values.data(), otherTensor.ld, 1};
+                if constexpr (std::is_same<Layout, RowMajor>::value)
+                    detail::gemmStrided<T>(cols, otherTensor.cols, rows, across, along,
+                                           result.values.data(), result.ld);
+                else
+                    // Column-major storage is the row-major transpose: C^T = other^T * this.
+                    detail::gemmStrided<T>(otherTensor.cols, cols, rows, along, across,
+                                           result.values.data(), result.ld);
+                return result;
+            }
+            else
+                return transpose() * otherTensor;
+        }
+
+        /**
+         * @brief Matrix product over a semiring, e.g. a.multiply<MinPlus>(b) for shortest paths.
+         * 
+         * Runs the same blocked and vectorized kernels as operator*, with
+         * Semiring<T>'s add and mul in place of + and * (see Semiring.hpp).
+         * 
+         * @tparam Semiring Semiring policy template: PlusTimes, MinPlus, MaxPlus, MaxTimes or OrAnd.
+         * @param otherTensor The tensor to multiply with.
+         * @return Product tensor; elements no k contributes to hold Semiring<T>::zero().
+         * @throws std::runtime_error if dimensions are incompatible.
+         */
+        template<template<typename> class Semiring>
+        Tensor<T, Layout> multiply(const Tensor<T, Layout>& otherTensor) const
+        {
+            if(cols != otherTensor.rows)
+                TENSOR_THROW(std::runtime_error, "Matrix dimensions incompatible for multiplication");
 
-    private:
-        size_t rows, cols;             ///< Number of rows and columns.
-        std::vector<T> data;           ///< Flat storage of matrix elements.
+            Tensor<T, Layout> result = resultLike(rows, otherTensor.cols);
+            if (Semiring<T>::zero() != T{})
+                result.fill(Semiring<T>::zero());
+            Layout::template gemm<T, Semiring<T>>(rows, otherTensor.cols, cols,
+                                                  values.data(), ld, otherTensor.values.data(), otherTensor.ld,
+                                                  result.values.data(), result.ld);
+            return result;
+        }
 
-    public:
         /**
-         * @brief Constructs a Tensor of specified dimensions, initialized with zeros.
+         * @brief Matrix multiplication into an existing tensor, without allocating.
+         * 
+         * Lets iterative algorithms ping-pong between preallocated buffers.
+         * 
+         * @param otherTensor The tensor to multiply with.
+         * @param result Receives (*this) * otherTensor; must already have the product's shape.
+         * @throws std::runtime_error if dimensions are incompatible.
+         * @throws std::invalid_argument if result is one of the operands.
+         */
+        void multiplyInto(const Tensor<T, Layout>& otherTensor, Tensor<T, Layout>& result) const
+        {
+            if(cols != otherTensor.rows || result.rows != rows || result.cols != otherTensor.cols)
+                TENSOR_THROW(std::runtime_error, "Matrix dimensions incompatible for multiplication");
+            if (&result == this || &result == &otherTensor)
+                TENSOR_THROW(std::invalid_argument, "Result can't alias an operand");
+
+            result.fill(T{});
+            if (multiplyStructured(otherTensor, result))
+                return;
+            Layout::gemm(rows, otherTensor.cols, cols,
+                         values.data(), ld, otherTensor.values.data(), otherTensor.ld,
+                         result.values.data(), result.ld);
+        }
+
+        /**
+         * @brief Non-throwing constructor, see Tensor(size_t, size_t).
          * 
          * @param rows Number of rows.
          * @param cols Number of columns.
-         * @throws std::invalid_argument if either dimension is zero.
+         * @return The zero tensor, or ErrorCode::ZeroSize.
          */
-        Tensor(size_t rows, size_t cols)
-            : rows(rows), cols(cols), data(rows * cols, T{})
+        static Result<Tensor<T, Layout>> tryCreate(size_t rows, size_t cols)
         {
             if (rows == 0 || cols == 0)
-                throw std::invalid_argument("Size can't be 0");
+                return failure(ErrorCode::ZeroSize);
+            return Tensor<T, Layout>(rows, cols);
         }
 
-        /// @brief Default destructor.
-        ~Tensor() = default;
-
         /**
-         * @brief Accesses (modifiable) the element at position (i, j).
+         * @brief Non-throwing read of the element at position (i, j).
          * 
          * @param i Row index.
          * @param j Column index.
-         * @return Reference to the element.
-         * @throws std::out_of_range on invalid indices.
+         * @return The element, or ErrorCode::OutOfRange.
          */
-        T& operator()(size_t i, size_t j)
+        Result<T> tryAt(size_t i, size_t j) const noexcept
         {
             if (i >= rows || j >= cols)
-                throw std::out_of_range("Index out of range: (" + std::to_string(i) + ", " + std::to_string(j) + ")");
-            return data[(i * cols) + j];
+                return failure(ErrorCode::OutOfRange);
+            return values[index(i, j)];
         }
 
         /**
-         * @brief Accesses (read-only) the element at position (i, j).
+         * @brief Non-throwing set().
          * 
          * @param i Row index.
          * @param j Column index.
-         * @return Const reference to the element.
-         * @throws std::out_of_range on invalid indices.
+         * @param value The value to store.
+         * @return Nothing, or ErrorCode::OutOfRange.
          */
-        const T& operator()(size_t i, size_t j) const
+        Result<void> trySet(size_t i, size_t j, const T& value) noexcept
         {
             if (i >= rows || j >= cols)
-                throw std::out_of_range("Index out of range: (" + std::to_string(i) + ", " + std::to_string(j) + ")");
-            return data[(i * cols) + j];
+                return failure(ErrorCode::OutOfRange);
+            set(i, j, value);
+            return {};
         }
 
         /**
-         * @brief Checks equality with another tensor.
+         * @brief Non-throwing elementWiseOp().
          * 
-         * @param otherTensor Tensor to compare.
-         * @return true if dimensions and elements match.
+         * @param otherTensor The other tensor.
+         * @param op Binary operation to apply.
+         * @return Resulting tensor, or ErrorCode::SizeMismatch.
          */
-        bool operator==(const Tensor<T>& otherTensor) const
+        template<typename BinaryOp>
+        Result<Tensor<T, Layout>> tryElementWiseOp(const Tensor<T, Layout>& otherTensor, BinaryOp op) const
         {
-            return rows == otherTensor.rows && cols == otherTensor.cols && data == otherTensor.data;
+            if (rows != otherTensor.rows || cols != otherTensor.cols)
+                return failure(ErrorCode::SizeMismatch);
+            return elementWiseOp(otherTensor, op);
         }
 
         /**
-         * @brief Checks inequality with another tensor.
+         * @brief Non-throwing matrix multiplication.
          * 
-         * @param otherTensor Tensor to compare.
-         * @return true if tensors differ.
+         * @param otherTensor The tensor to multiply with.
+         * @return Product tensor, or ErrorCode::IncompatibleDimensions.
          */
-        bool operator!=(const Tensor<T>& otherTensor) const
+        Result<Tensor<T, Layout>> tryMultiply(const Tensor<T, Layout>& otherTensor) const
         {
-            return !(*this == otherTensor);
+            if (cols != otherTensor.rows)
+                return failure(ErrorCode::IncompatibleDimensions);
+            return *this * otherTensor;
         }
 
         /**
-         * @brief Performs an element-wise operation with another tensor.
+         * @brief Non-throwing multiplyInto().
          * 
-         * @tparam BinaryOp A callable binary operator (e.g., std::plus).
-         * @param otherTensor The other tensor.
-         * @param op Binary operation to apply.
-         * @return Resulting tensor.
-         * @throws std::runtime_error if dimensions mismatch.
+         * @param otherTensor The tensor to multiply with.
+         * @param result Receives (*this) * otherTensor.
+         * @return Nothing, or ErrorCode::IncompatibleDimensions / ErrorCode::AliasedResult.
          */
-        template<typename BinaryOp>
-        inline Tensor<T> elementWiseOp(const Tensor<T>& otherTensor, BinaryOp op) const
+        Result<void> tryMultiplyInto(const Tensor<T, Layout>& otherTensor, Tensor<T, Layout>& result) const
         {
-            if(rows != otherTensor.rows || cols != otherTensor.cols)
-                throw std::runtime_error("Size mismatch");
-
-            Tensor<T> result(rows, cols);
-            std::transform(data.begin(), data.end(), otherTensor.data.begin(), result.data.begin(), op);
-            return result;
+            if (cols != otherTensor.rows || result.rows != rows || result.cols != otherTensor.cols)
+                return failure(ErrorCode::IncompatibleDimensions);
+            if (&result == this || &result == &otherTensor)
+                return failure(ErrorCode::AliasedResult);
+            multiplyInto(otherTensor, result);
+            return {};
         }
 
         /**
-         * @brief Element-wise addition with another tensor.
+         * @brief Returns the number of rows.
          * 
-         * @param otherTensor The tensor to add.
-         * @return Sum tensor.
+         * @return Number of rows.
+         */
+        constexpr size_t rowCount() const { return rows; }
+
+        /**
+         * @brief Returns the number of columns.
+         * 
+         * @return Number of columns.
+         */
+        constexpr size_t colCount() const { return cols; }
+
+        /**
+         * @brief Returns the leading dimension of the storage.
+         * 
+         * @return Stride between consecutive rows (RowMajor), columns (ColMajor)
+         *         or element rows of a tile row (Blocked).
+         */
+        constexpr size_t leadingDim() const { return ld; }
+
+        /**
+         * @brief Returns the number of elements.
+         * 
+         * @return rows * cols.
+         */
+        constexpr size_t size() const { return rows * cols; }
+
+        /**
+         * @brief Reports whether the storage holds the elements with no padding.
+         * 
+         * Only then do begin() and end() span exactly the elements.
+         * 
+         * @return true if the storage is contiguous.
+         */
+        bool isContiguous() const { return isDense(); }
+
+        /**
+         * @brief Pointer to the storage, elements in Layout order.
+         * 
+         * The non-const overload counts as a write when it is called: the
+         * tracked hash and version() are invalidated then, not on later stores
+         * through the pointer. It can't tell reads from writes, so read
+         * through cdata() (or the const overload) instead.
+         * 
+         * @return Start of the storage.
+         */
+        T* data() { markWritten(); return values.data(); }
+
+        /// @copydoc data()
+        const T* data() const { return values.data(); }
+
+        /// @brief Read-only data(), which leaves version() and the write log as they are.
+        const T* cdata() const { return values.data(); }
+
+        /**
+         * @brief Contiguous iterator to the first element in storage order.
+         * 
+         * Iterators are plain pointers, so a tensor is a contiguous range for
+         * std::ranges and works with the parallel standard algorithms. Like
+         * data(), the non-const overload counts as a write, so loops that only
+         * read should use cbegin()/cend() or std::as_const(t). Padded tensors
+         * have no single contiguous range; walk them with row() or col().
+         * 
+         * @return Pointer to the first element.
+         * @throws std::logic_error if the storage is padded (see isContiguous()).
+         */
+        T* begin() { return contiguousData(); }
+
+        /// @copydoc begin()
+        const T* begin() const { return contiguousData(); }
+
+        /**
+         * @brief Iterator past the last element in storage order.
+         * 
+         * @return begin() + size().
+         * @throws std::logic_error if the storage is padded (see isContiguous()).
+         */
+        T* end() { return contiguousData() + size(); }
+
+        /// @copydoc end()
+        const T* end() const { return contiguousData() + size(); }
+
+        /// @brief Read-only begin().
+        const T* cbegin() const { return begin(); }
+
+        /// @brief Read-only end().
+        const T* cend() const { return end(); }
+
+#if defined(__cpp_lib_span)
+        /**
+         * @brief Row i as a span; available for row-major tensors.
+         * 
+         * Rows stay contiguous whatever the leading dimension, so this is the
+         * way to walk padded tensors. The non-const overload counts as a write.
+         * 
+         * @param i Row index.
+         * @return Span of the cols elements of row i.
+         * @throws std::out_of_range if i is out of range.
          */
-        Tensor<T> operator+(const Tensor<T>&& otherTensor) const
+        std::span<T> row(size_t i)
         {
-            return elementWiseOp(otherTensor, std::plus<T>());
+            static_assert(std::is_same<Layout, RowMajor>::value, "row() requires RowMajor storage");
+            if (i >= rows)
+                TENSOR_THROW(std::out_of_range, "Row out of range: " + std::to_string(i));
+            stale = staleAll;
+            versionStamp.reset();
+            if (writeLog.lines)
+                writeLog.row(i);
+            return std::span<T>(values.data() + (i * ld), cols);
+        }
+
+        /// @copydoc row()
+        std::span<const T> row(size_t i) const
+        {
+            static_assert(std::is_same<Layout, RowMajor>::value, "row() requires RowMajor storage");
+            if (i >= rows)
+                TENSOR_THROW(std::out_of_range, "Row out of range: " + std::to_string(i));
+            return std::span<const T>(values.data() + (i * ld), cols);
         }
 
         /**
-         * @brief Element-wise subtraction with another tensor.
+         * @brief Column j as a span; available for column-major tensors.
          * 
-         * @param otherTensor The tensor to subtract.
-         * @return Difference tensor.
+         * @param j Column index.
+         * @return Span of the rows elements of column j.
+         * @throws std::out_of_range if j is out of range.
          */
-        Tensor<T> operator-(const Tensor<T>&& otherTensor) const
+        std::span<T> col(size_t j)
         {
-            return elementWiseOp(otherTensor, std::minus<T>());
+            static_assert(std::is_same<Layout, ColMajor>::value, "col() requires ColMajor storage");
+            if (j >= cols)
+                TENSOR_THROW(std::out_of_range, "Column out of range: " + std::to_string(j));
+            stale = staleAll;
+            versionStamp.reset();
+            if (writeLog.lines)
+                writeLog.col(j);
+            return std::span<T>(values.data() + (j * ld), rows);
+        }
+
+        /// @copydoc col()
+        std::span<const T> col(size_t j) const
+        {
+            static_assert(std::is_same<Layout, ColMajor>::value, "col() requires ColMajor storage");
+            if (j >= cols)
+                TENSOR_THROW(std::out_of_range, "Column out of range: " + std::to_string(j));
+            return std::span<const T>(values.data() + (j * ld), rows);
         }
+#endif
 
         /**
-         * @brief Scalar multiplication.
+         * @brief Copies the tensor into another storage layout.
          * 
-         * @param scalar Value to multiply each element.
-         * @return Scaled tensor.
+         * Walks the matrix in 32 x 32 blocks so both the source and the
+         * destination stay cache resident, e.g. when converting row-major values
+         * for Fortran-order consumers.
+         * 
+         * @tparam OtherLayout Target layout.
+         * @return Tensor with the same elements in OtherLayout order.
          */
-        Tensor<T> operator*(const T& scalar) const
+        template<typename OtherLayout>
+        Tensor<T, OtherLayout> toLayout() const
         {
-            Tensor<T> result(rows, cols);
-            std::transform(data.begin(), data.end(), result.data.begin(),
-                           [&scalar](const T& val){ return val * scalar; });
+            constexpr size_t block = 32;
+            Tensor<T, OtherLayout> result(rows, cols);
+            for (size_t i0 = 0; i0 < rows; i0 += block)
+                for (size_t j0 = 0; j0 < cols; j0 += block)
+                {
+                    const size_t iEnd = std::min(rows, i0 + block);
+                    const size_t jEnd = std::min(cols, j0 + block);
+                    for (size_t i = i0; i < iEnd; ++i)
+                        for (size_t j = j0; j < jEnd; ++j)
+                            result.values[result.index(i, j)] = values[index(i, j)];
+                }
             return result;
         }
 
         /**
-         * @brief Matrix multiplication with another tensor.
+         * @brief Returns the transpose of the tensor.
          * 
-         * @param otherTensor The tensor to multiply with.
-         * @return Product tensor.
-         * @throws std::runtime_error if dimensions are incompatible.
+         * @return Transposed tensor.
          */
-        Tensor<T> operator*(const Tensor<T>& otherTensor) const
+        Tensor<T, Layout> transpose() const
         {
-            if(cols != otherTensor.rows)
-                throw std::runtime_error("Matrix dimensions incompatible for multiplication");
-
-            size_t T1 = rows;
-            size_t T2 = otherTensor.cols;
-            Tensor<T> result(T1, T2);
-
-            for (size_t i = 0; i < rows; ++i)
-            {
-                for (size_t j = 0; j < otherTensor.cols; ++j)
+            constexpr size_t block = 32;
+            Tensor<T, Layout> result = resultLike(cols, rows);
+            for (size_t i0 = 0; i0 < rows; i0 += block)
+                for (size_t j0 = 0; j0 < cols; j0 += block)
                 {
-                    T sum = T{};
-                    for (size_t k = 0; k < cols; ++k)
-                    {
-                        sum += (*this)(i, k) * otherTensor(k, j);
-                    }
-                    result(i, j) = sum;
+                    const size_t iEnd = std::min(rows, i0 + block);
+                    const size_t jEnd = std::min(cols, j0 + block);
+                    for (size_t i = i0; i < iEnd; ++i)
+                        for (size_t j = j0; j < jEnd; ++j)
+                            result.values[result.index(j, i)] = values[index(i, j)];
                 }
+            if (!(stale & staleStructure))
+            {
+                // Transposing swaps the triangles.
+                const uint8_t swapped = static_cast<uint8_t>(structureBits & ~(upperBit | lowerBit));
+                result.setStructure(static_cast<uint8_t>(swapped | ((structureBits & upperBit) ? lowerBit : 0)
+                                                         | ((structureBits & lowerBit) ? upperBit : 0)));
             }
             return result;
         }
 
         /**
-         * @brief Returns the number of rows.
+         * @brief Kronecker product with another tensor.
          * 
-         * @return Number of rows.
-         */
-        constexpr size_t rowCount() const { return rows; }
-
-        /**
-         * @brief Returns the number of columns.
+         * Block (i, j) of the result is this(i, j) * otherTensor. Each output
+         * line is a scaled line of one operand, written with the vector scale
+         * kernel. See KroneckerView to apply A (x) B without forming it.
          * 
-         * @return Number of columns.
+         * @param otherTensor Right operand.
+         * @return (rows * other.rows) x (cols * other.cols) tensor.
          */
-        constexpr size_t colCount() const { return cols; }
+        Tensor<T, Layout> kron(const Tensor<T, Layout>& otherTensor) const
+        {
+            const size_t pr = otherTensor.rows, pc = otherTensor.cols;
+            Tensor<T, Layout> result(rows * pr, cols * pc);
+            if constexpr (std::is_same<Layout, RowMajor>::value || std::is_same<Layout, ColMajor>::value)
+            {
+                // Work in storage terms: "lines" are rows for RowMajor, columns for ColMajor.
+                constexpr bool rowMajor = std::is_same<Layout, RowMajor>::value;
+                const size_t outer = rowMajor ? rows : cols, inner = rowMajor ? cols : rows;
+                const size_t lines = rowMajor ? pr : pc, lineLength = rowMajor ? pc : pr;
+                for (size_t a = 0; a < outer; ++a)
+                    for (size_t p = 0; p < lines; ++p)
+                    {
+                        T* out = result.values.data() + (((a * lines) + p) * result.ld);
+                        const T* src = otherTensor.values.data() + (p * otherTensor.ld);
+                        for (size_t b = 0; b < inner; ++b)
+                            scaleRun(src, values[(a * ld) + b], out + (b * lineLength), lineLength);
+                    }
+            }
+            else
+            {
+                for (size_t i = 0; i < rows; ++i)
+                    for (size_t j = 0; j < cols; ++j)
+                    {
+                        const T aij = values[index(i, j)];
+                        for (size_t p = 0; p < pr; ++p)
+                            for (size_t q = 0; q < pc; ++q)
+                                result.values[result.index((i * pr) + p, (j * pc) + q)] = aij * otherTensor.values[otherTensor.index(p, q)];
+                    }
+            }
+            return result;
+        }
 
         /**
-         * @brief Returns the transpose of the tensor.
+         * @brief Outer product u * v^T of two vectors.
          * 
-         * @return Transposed tensor.
+         * @param u Left vector, a single row or column.
+         * @param v Right vector, a single row or column.
+         * @return u.size() x v.size() tensor.
+         * @throws std::invalid_argument if an operand is not a vector.
          */
-        Tensor<T> transpose() const
+        static Tensor<T, Layout> outer(const Tensor<T, Layout>& u, const Tensor<T, Layout>& v)
         {
-            Tensor<T> result(cols, rows);
-            for (size_t i = 0; i < rows; ++i)
+            if ((u.rows != 1 && u.cols != 1) || (v.rows != 1 && v.cols != 1))
+                TENSOR_THROW(std::invalid_argument, "Outer product operands must be vectors");
+
+            const std::vector<T> us = u.flatten(), vs = v.flatten();
+            Tensor<T, Layout> result(us.size(), vs.size());
+            if constexpr (std::is_same<Layout, RowMajor>::value)
             {
-                for (size_t j = 0; j < cols; ++j)
-                {
-                    result(j, i) = (*this)(i, j);
-                }
+                for (size_t i = 0; i < us.size(); ++i)
+                    scaleRun(vs.data(), us[i], result.values.data() + (i * result.ld), vs.size());
+            }
+            else if constexpr (std::is_same<Layout, ColMajor>::value)
+            {
+                for (size_t j = 0; j < vs.size(); ++j)
+                    scaleRun(us.data(), vs[j], result.values.data() + (j * result.ld), us.size());
+            }
+            else
+            {
+                for (size_t i = 0; i < us.size(); ++i)
+                    for (size_t j = 0; j < vs.size(); ++j)
+                        result.values[result.index(i, j)] = us[i] * vs[j];
             }
             return result;
         }
@@ -230,7 +2053,178 @@ namespace Tensor
         void fill(const U& value)
         {
             static_assert(std::is_convertible<U, T>::value, "U must be convertible to T");
-            std::fill(data.begin(), data.end(), static_cast<T>(value));
+            markWritten();
+            forEachRunParallel([&](size_t offset, size_t length)
+            {
+                std::fill(values.begin() + offset, values.begin() + offset + length, static_cast<T>(value));
+            });
+        }
+
+        /**
+         * @brief Writes the element at position (i, j).
+         * 
+         * Unlike the reference returned by operator(), this keeps the tracked
+         * hash valid when hash tracking is enabled.
+         * 
+         * @param i Row index.
+         * @param j Column index.
+         * @param value The value to store.
+         * @throws std::out_of_range on invalid indices.
+         */
+        void set(size_t i, size_t j, const T& value)
+        {
+            if (i >= rows || j >= cols)
+                TENSOR_THROW(std::out_of_range, "Index out of range: (" + std::to_string(i) + ", " + std::to_string(j) + ")");
+            T& slot = values[index(i, j)];
+            if (hashTracking && !(stale & staleHash))
+            {
+                trackedSum += hashTerm(i, j, value) - hashTerm(i, j, slot);
+                stale = static_cast<uint8_t>(staleAll & ~staleHash);
+                versionStamp.reset();
+                if (writeLog.lines)
+                    writeLog.element(i, j);
+            }
+            else
+                markWritten(i, j);
+            slot = value;
+        }
+
+        /**
+         * @brief Hashes the shape and contents, e.g. to key cached results.
+         * 
+         * Covers the raw bytes of every element (so 0.0 and -0.0 differ) in
+         * storage order, skipping layout padding; the same matrix hashes
+         * differently per layout. Streams the values through a vectorized
+         * XXH3-style kernel.
+         * 
+         * @param seed Value mixed into the hash.
+         * @return 64-bit content hash.
+         */
+        uint64_t contentHash(uint64_t seed = 0) const
+        {
+            static_assert(sizeof(T) <= sizeof(uint64_t), "Hashing requires element types of at most 8 bytes");
+            detail::ContentHasher hasher(seed);
+            const uint64_t shape[2] = {rows, cols};
+            hasher.update(shape, sizeof shape);
+            forEachRun([&](size_t offset, size_t length)
+            {
+                hasher.update(values.data() + offset, length * sizeof(T));
+            });
+            return hasher.digest();
+        }
+
+        /**
+         * @brief Enables or disables incremental maintenance of trackedHash().
+         * 
+         * @param enable true to update the hash in O(1) on every set().
+         */
+        void trackHash(bool enable = true)
+        {
+            hashTracking = enable;
+        }
+
+        /**
+         * @brief Returns a content hash that set() can maintain incrementally.
+         * 
+         * The hash is a sum of per-element terms, so with tracking enabled a
+         * write through set() updates it in O(1). Writes through operator() or
+         * fill() can't be observed and mark it stale; the next call then
+         * rebuilds it in O(n). Differs from contentHash().
+         * 
+         * @return 64-bit content hash.
+         */
+        uint64_t trackedHash() const
+        {
+            if (stale & staleHash)
+            {
+                trackedSum = 0;
+                for (size_t i = 0; i < rows; ++i)
+                    for (size_t j = 0; j < cols; ++j)
+                        trackedSum += hashTerm(i, j, values[index(i, j)]);
+                stale = static_cast<uint8_t>(stale & ~staleHash);
+            }
+            return trackedSum ^ detail::ContentHasher::mixWord(rows, cols);
+        }
+
+        /**
+         * @brief Enables or disables per-row and per-column write stamps, see writtenSince().
+         * 
+         * While enabled, each write through operator(), set(), row() or col()
+         * records the lines it touched, at the cost of a relaxed load of the
+         * stamp counter and two stores; bulk writes (fill(), data(),
+         * assignment) record the whole tensor. Like version(), the non-const
+         * operator() records a read through it as a write; IncrementalProduct
+         * checks such lines against its copy and skips the unchanged ones.
+         * Enabling counts as a write of the whole tensor.
+         * 
+         * @param enable true to record written lines.
+         */
+        void trackWrites(bool enable = true)
+        {
+            if (!enable)
+                writeLog.lines.reset();
+            else if (!writeLog.lines)
+            {
+                writeLog.lines = std::make_unique<detail::WriteLog::Lines>();
+                writeLog.lines->rowStamps.assign(rows, 0);
+                writeLog.lines->colStamps.assign(cols, 0);
+                writeLog.all();
+            }
+        }
+
+        /**
+         * @brief Returns a stamp ordering writes: later ones are reported by writtenSince(stamp).
+         * 
+         * Advances the shared counter, so every write after it is stamped higher.
+         * 
+         * @return Current stamp.
+         */
+        static uint64_t writeStamp()
+        {
+            return detail::nextVersion();
+        }
+
+        /**
+         * @brief Rows and columns holding every element written after a stamp.
+         * 
+         * A whole row written (row()) puts every column in the result and a
+         * whole column every row. Without trackWrites(), or after a bulk
+         * write, every row and column is reported.
+         * 
+         * @param stamp Value returned by writeStamp() earlier.
+         * @return The written lines.
+         */
+        WrittenLines writtenSince(uint64_t stamp) const
+        {
+            WrittenLines written;
+            const detail::WriteLog::Lines* lines = writeLog.lines.get();
+            const bool allRows = !lines || lines->whole > stamp || lines->wholeCol > stamp;
+            const bool allCols = !lines || lines->whole > stamp || lines->wholeRow > stamp;
+            for (size_t i = 0; i < rows; ++i)
+                if (allRows || lines->rowStamps[i] > stamp)
+                    written.rows.push_back(i);
+            for (size_t j = 0; j < cols; ++j)
+                if (allCols || lines->colStamps[j] > stamp)
+                    written.cols.push_back(j);
+            return written;
+        }
+
+        /**
+         * @brief Returns an identifier of the current contents.
+         * 
+         * Equal versions imply equal contents: copies share the version, and
+         * the first call after any write through the Tensor API hands out a
+         * new, never reused one. References kept from operator() across a
+         * call bypass this, so don't hold them. Cheaper than hashing for
+         * keying cached results by operand identity. Safe to call from
+         * several threads at once, as long as none of them writes the tensor
+         * meanwhile; racing first calls agree on one stamp.
+         * 
+         * @return Version stamp.
+         */
+        uint64_t version() const
+        {
+            return versionStamp.get();
         }
 
         /**
@@ -254,7 +2248,7 @@ namespace Tensor
         T determinant()
         {
             if(rows != cols)
-                throw std::runtime_error("Matrix is not square");
+                TENSOR_THROW(std::runtime_error, "Matrix is not square");
             ...
         }
         */
@@ -264,14 +2258,48 @@ namespace Tensor
      * @brief Scalar multiplication.
      * 
      * @tparam T Tensor value type.
+     * @tparam Layout Tensor storage layout.
      * @tparam U Scalar type.
      * @param scalar The scalar value.
      * @param tensor The tensor.
      * @return Scaled tensor.
      */
-    template<typename T, typename U>
-    Tensor<T> operator*(const U& scalar, const Tensor<T>& tensor)
+    template<typename T, typename Layout, typename U>
+    Tensor<T, Layout> operator*(const U& scalar, const Tensor<T, Layout>& tensor)
     {
         return tensor * scalar;
     }
+
+    namespace detail
+    {
+        /**
+         * @brief Raw storage access for kernels that live outside Tensor.hpp.
+         */
+        struct TensorAccess
+        {
+            template<typename T, typename Layout>
+            static T* storage(Tensor<T, Layout>& tensor) { tensor.markWritten(); return tensor.values.data(); }
+
+            template<typename T, typename Layout>
+            static const T* storage(const Tensor<T, Layout>& tensor) { return tensor.values.data(); }
+
+            template<typename T, typename Layout>
+            static size_t leadingDim(const Tensor<T, Layout>& tensor) { return tensor.ld; }
+
+            template<typename T, typename Layout, typename F>
+            static void forEachRunParallel(const Tensor<T, Layout>& tensor, F&& f) { tensor.forEachRunParallel(f); }
+        };
+    }
+
+    /**
+     * @brief Hash functor over tensor contents, for unordered containers keyed by Tensor.
+     */
+    struct ContentHash
+    {
+        template<typename T, typename Layout>
+        size_t operator()(const Tensor<T, Layout>& tensor) const
+        {
+            return static_cast<size_t>(tensor.contentHash());
+        }
+    };
 }
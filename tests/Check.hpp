@@ -0,0 +1,123 @@
+/**
+ * @file Check.hpp
+ * @brief Assertion macro and reference helpers shared by the test programs.
+ *
+ * Every test is a standalone program, built from the repository root with e.g.
+ * g++ -std=c++23 -O2 -pthread tests/test_layout.cpp -o test_layout
+ * It prints each failed check and exits with a non-zero status if any failed.
+ * @author r4qq
+ * @date 2025
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "../Tensor.hpp"
+
+namespace check
+{
+    inline int failures = 0;
+
+    /// @brief Exit status of a test program: 0 if every check passed.
+    inline int result()
+    {
+        if (failures != 0)
+            std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return failures != 0 ? 1 : 0;
+    }
+
+    /// @brief Deterministic pseudo-random values in [-1, 1) (xorshift), identical on every platform.
+    class Values
+    {
+    private:
+        uint64_t state;
+
+    public:
+        explicit Values(uint64_t seed = 1) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+        double next()
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return (static_cast<double>(state >> 11) / 9007199254740992.0 * 2.0) - 1.0;
+        }
+    };
+
+    /// @brief rows x cols tensor of Values; integer types get values in [-8, 8].
+    template<typename T, typename Layout = Tensor::RowMajor>
+    Tensor::Tensor<T, Layout> random(size_t rows, size_t cols, uint64_t seed = 1)
+    {
+        Values values(seed);
+        Tensor::Tensor<T, Layout> m(rows, cols);
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t j = 0; j < cols; ++j)
+                m(i, j) = std::is_floating_point<T>::value ? static_cast<T>(values.next())
+                                                           : static_cast<T>(std::lround(values.next() * 8));
+        return m;
+    }
+
+    /// @brief Textbook triple loop product, the reference every kernel is checked against.
+    template<typename T, typename Layout>
+    Tensor::Tensor<T, Layout> naiveProduct(const Tensor::Tensor<T, Layout>& a, const Tensor::Tensor<T, Layout>& b)
+    {
+        Tensor::Tensor<T, Layout> c(a.rowCount(), b.colCount());
+        for (size_t i = 0; i < a.rowCount(); ++i)
+            for (size_t j = 0; j < b.colCount(); ++j)
+            {
+                T sum = T{};
+                for (size_t k = 0; k < a.colCount(); ++k)
+                    sum += a(i, k) * b(k, j);
+                c(i, j) = sum;
+            }
+        return c;
+    }
+
+    /// @brief Largest |a(i, j) - b(i, j)|, or infinity if the shapes differ.
+    template<typename T, typename LayoutA, typename LayoutB>
+    double maxDiff(const Tensor::Tensor<T, LayoutA>& a, const Tensor::Tensor<T, LayoutB>& b)
+    {
+        if (a.rowCount() != b.rowCount() || a.colCount() != b.colCount())
+            return INFINITY;
+        double worst = 0;
+        for (size_t i = 0; i < a.rowCount(); ++i)
+            for (size_t j = 0; j < a.colCount(); ++j)
+            {
+                const double d = std::fabs(static_cast<double>(a(i, j)) - static_cast<double>(b(i, j)));
+                worst = std::isnan(d) ? INFINITY : std::max(worst, d);
+            }
+        return worst;
+    }
+}
+
+/// @brief Records and reports a failed condition without stopping the test.
+#define CHECK(condition)                                                                  \
+    do                                                                                    \
+    {                                                                                     \
+        if (!(condition))                                                                 \
+        {                                                                                 \
+            ++::check::failures;                                                          \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+        }                                                                                 \
+    } while (false)
+
+/// @brief CHECK that evaluating the expression throws Exception (skipped in builds without exceptions).
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define CHECK_THROWS(Exception, ...)                                                      \
+    do                                                                                    \
+    {                                                                                     \
+        bool thrown = false;                                                              \
+        try { (void)(__VA_ARGS__); } catch (const Exception&) { thrown = true; }          \
+        if (!thrown)                                                                      \
+        {                                                                                 \
+            ++::check::failures;                                                          \
+            std::fprintf(stderr, "%s:%d: %s didn't throw %s\n", __FILE__, __LINE__, #__VA_ARGS__, #Exception); \
+        }                                                                                 \
+    } while (false)
+#else
+#define CHECK_THROWS(Exception, ...) do { } while (false)
+#endif
@@ -16,7 +16,7 @@ int main(void)
     B = B.transpose();
     B.print();   
 
-    auto C = A * B;
+    auto C = A * B.transpose();
     C.print();
 
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "Check.hpp"
+#include "../BitMatrix.hpp"
+
+using Tensor::BitMatrix;
+template<typename T> using Mat = Tensor::Tensor<T>;
+
+/// A 0/1 matrix with roughly one element in `sparsity` set.
+static Mat<int> bits(size_t rows, size_t cols, uint64_t seed, double sparsity = 3)
+{
+    check::Values values(seed);
+    Mat<int> m(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            m(i, j) = (values.next() + 1) * sparsity < 2;
+    return m;
+}
+
+/// Every kernel against the same loops over the unpacked 0/1 matrices.
+static void sameAsUnpacked(size_t m, size_t k, size_t n)
+{
+    const Mat<int> a = bits(m, k, m + k);
+    const Mat<int> b = bits(k, n, k + n);
+    const Mat<int> c = bits(n, k, n + k + 1);
+    const BitMatrix pa = BitMatrix::fromTensor(a);
+    const BitMatrix pb = BitMatrix::fromTensor(b);
+    const BitMatrix pc = BitMatrix::fromTensor(c);
+
+    CHECK(pa.toTensor<int>() == a && pa.wordCount() == (k + 63) / 64);
+    CHECK(pa.count() == static_cast<size_t>(a.sum()));
+    CHECK(pa.transpose() == BitMatrix::fromTensor(a.transpose()));
+
+    Mat<int> product(m, n), shared(m, n), hamming(m, n);
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+        {
+            int any = 0, both = 0, differ = 0;
+            for (size_t x = 0; x < k; ++x)
+            {
+                any |= a(i, x) & b(x, j);
+                both += a(i, x) & c(j, x);
+                differ += a(i, x) ^ c(j, x);
+            }
+            product(i, j) = any;
+            shared(i, j) = both;
+            hamming(i, j) = differ;
+        }
+    CHECK((pa * pb).toTensor<int>() == product);
+    const Mat<uint32_t> intersections = pa.intersections(pc);
+    const Mat<uint32_t> distances = pa.hammingDistances(pc);
+    bool same = true;
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+            same = same && intersections(i, j) == static_cast<uint32_t>(shared(i, j))
+                        && distances(i, j) == static_cast<uint32_t>(hamming(i, j));
+    CHECK(same);
+
+    // Bits past the last column stay zero, so whole-word kernels never count them.
+    for (size_t i = 0; i < m; ++i)
+        if (k % 64 != 0)
+            CHECK((pa.row(i)[pa.wordCount() - 1] >> (k % 64)) == 0);
+}
+
+int main()
+{
+    const size_t shapes[][3] = {{1, 1, 1}, {5, 63, 7}, {9, 64, 65}, {17, 65, 3}, {33, 130, 129}, {300, 1000, 200}};
+    for (const auto& s : shapes)
+        sameAsUnpacked(s[0], s[1], s[2]);
+
+    BitMatrix m(3, 70);
+    m.set(2, 69, true);
+    m.set(0, 0, true);
+    m.set(0, 0, false);
+    CHECK(m(2, 69) && !m(0, 0) && m.count() == 1);
+    CHECK(m != BitMatrix(3, 70));
+    CHECK_THROWS(std::out_of_range, m(3, 0));
+    CHECK_THROWS(std::out_of_range, m.set(0, 70, true));
+    CHECK_THROWS(std::out_of_range, m.row(3));
+    CHECK_THROWS(std::invalid_argument, BitMatrix(0, 4));
+    CHECK_THROWS(std::runtime_error, m * m);
+    CHECK_THROWS(std::runtime_error, m.intersections(BitMatrix(3, 71)));
+
+    // Reachability: squaring (I + A) until it stops changing gives the transitive closure.
+    const size_t n = 200;
+    BitMatrix step(n, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        step.set(i, i, true);
+        step.set(i, (i * 7 + 3) % n, true);
+    }
+    BitMatrix closure = step;
+    for (BitMatrix next = closure * closure; next != closure; next = closure * closure)
+        closure = next;
+    Mat<int> reach = step.toTensor<int>();
+    for (size_t k = 0; k < n; ++k)
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                reach(i, j) |= reach(i, k) & reach(k, j);
+    CHECK(closure.toTensor<int>() == reach);
+    return check::result();
+}
@@ -0,0 +1,104 @@
+#include "Check.hpp"
+#include "../ProductCache.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using Tensor::CacheKey;
+template<typename T> using Mat = Tensor::Tensor<T>;
+
+static void versions()
+{
+    Mat<double> a = check::random<double>(8, 8);
+    const uint64_t v = a.version();
+    CHECK(v != 0 && a.version() == v);
+    Mat<double> copy = a;
+    CHECK(copy.version() == v);
+    a(0, 0) = 2;
+    CHECK(a.version() != v && copy.version() == v);
+    a.set(1, 1, 3);
+    const uint64_t w = a.version();
+    a.fill(1);
+    CHECK(a.version() != w);
+
+    // Racing first calls after a write all see the one stamp that won.
+    for (int round = 0; round < 50; ++round)
+    {
+        a(0, 0) = round;
+        std::vector<uint64_t> seen(8);
+        std::vector<std::thread> readers;
+        for (size_t t = 0; t < seen.size(); ++t)
+            readers.emplace_back([&, t] { seen[t] = a.version(); });
+        for (auto& reader : readers)
+            reader.join();
+        bool agree = true;
+        for (uint64_t s : seen)
+            agree = agree && s == seen[0];
+        CHECK(agree && a.version() == seen[0]);
+    }
+}
+
+static void lookups()
+{
+    const Mat<double> w = check::random<double>(64, 64, 1);
+    Mat<double> x = check::random<double>(64, 8, 2);
+    Tensor::ProductCache<double> cache(64 * 8 * sizeof(double) * 2);
+
+    auto first = cache.multiply(w, x);
+    CHECK(cache.multiply(w, x) == first);
+    CHECK(check::maxDiff(*first, check::naiveProduct(w, x)) < 1e-12);
+    Mat<double> copy = x;
+    CHECK(cache.multiply(w, copy) == first);
+
+    copy(0, 0) = 5;
+    auto changed = cache.multiply(w, copy);
+    CHECK(changed != first && check::maxDiff(*changed, check::naiveProduct(w, copy)) < 1e-12);
+    Mat<double> other = x;
+    other(1, 1) = 100;
+    cache.multiply(w, other);   // a third product, which evicts the least recently used
+    const Tensor::CacheStats stats = cache.stats();
+    CHECK(stats.hits == 2 && stats.misses == 3 && stats.evictions == 1 && stats.entries == 2);
+
+    // Content keys hit for equal contents built independently.
+    Tensor::ProductCache<double> byContent(1 << 20, CacheKey::Content);
+    byContent.multiply(w, x);
+    byContent.multiply(w, check::random<double>(64, 8, 2));
+    CHECK(byContent.stats().hits == 1);
+
+    // A product over the budget is computed but not kept.
+    Tensor::ProductCache<double> tiny(16);
+    CHECK(check::maxDiff(*tiny.multiply(w, x), *first) == 0);
+    CHECK(tiny.stats().entries == 0);
+}
+
+/// Threads sharing a cache and never-before-versioned operands all get correct, shared products.
+static void threads()
+{
+    const Mat<double> w = check::random<double>(48, 48, 3);
+    const Mat<double> x = check::random<double>(48, 16, 4);
+    const Mat<double> expected = check::naiveProduct(w, x);
+    Tensor::ProductCache<double> cache(1 << 20);
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> users;
+    for (int t = 0; t < 8; ++t)
+        users.emplace_back([&]
+        {
+            for (int k = 0; k < 200; ++k)
+                if (check::maxDiff(*cache.multiply(w, x), expected) > 1e-12)
+                    ++wrong;
+        });
+    for (auto& user : users)
+        user.join();
+    const Tensor::CacheStats stats = cache.stats();
+    CHECK(wrong.load() == 0);
+    CHECK(stats.entries == 1 && stats.hits + stats.misses == 1600 && stats.misses <= 8);
+}
+
+int main()
+{
+    versions();
+    lookups();
+    threads();
+    return check::result();
+}
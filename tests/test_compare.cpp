@@ -0,0 +1,64 @@
+#include "Check.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+using Tensor::Blocked;
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+template<typename T, typename Layout>
+static void tolerances(size_t m, size_t n)
+{
+    Mat<T, Layout> a(m, n), b(m, n);
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+            a(i, j) = b(i, j) = static_cast<T>((i * 0.5) + j);
+    CHECK(a == b && a.allClose(b));
+    CHECK(a.maxAbsDiff(b) == 0 && a.maxUlpDistance(b) == 0);
+
+    // One ulp apart in the last element, which sits in the vector kernels' tail.
+    b(m - 1, n - 1) = std::nextafter(b(m - 1, n - 1), static_cast<T>(1e9));
+    CHECK(a != b);
+    CHECK(a.maxUlpDistance(b) == 1 && a.withinUlps(b, 1) && !a.withinUlps(b, 0));
+    CHECK(a.allClose(b));
+
+    b(m / 2, n / 2) += T{1};
+    CHECK(!a.allClose(b));
+    CHECK(std::fabs(a.maxAbsDiff(b) - T{1}) < 1e-3);
+    const auto less = a.compare(b, std::less<T>());
+    const auto close = a.isClose(b);
+    CHECK(less(m / 2, n / 2) == 1 && close(m / 2, n / 2) == 0);
+    if (m > 1 || n > 1)
+        CHECK(less(0, 0) == 0 && close(0, 0) == 1);
+
+    // NaN is never close, not even to itself; equal infinities are.
+    b(0, 0) = std::numeric_limits<T>::quiet_NaN();
+    CHECK(!a.allClose(b));
+    CHECK(std::isnan(a.maxAbsDiff(b)));
+    CHECK(a.maxUlpDistance(b) == UINT64_MAX);
+    a(0, 0) = b(0, 0) = std::numeric_limits<T>::infinity();
+    b(m / 2, n / 2) = a(m / 2, n / 2);
+    CHECK(a.allClose(b));
+
+    CHECK(!a.allClose(Mat<T, Layout>(m + 1, n)));
+}
+
+int main()
+{
+    for (size_t m : {1, 5, 40})
+        for (size_t n : {1, 3, 37})
+        {
+            tolerances<float, RowMajor>(m, n);
+            tolerances<double, Blocked<8>>(m, n);
+            tolerances<float, ColMajor>(m, n);
+        }
+
+    Mat<int> zero(3, 3), one(3, 3);
+    one(1, 1) = 1;
+    CHECK(!zero.allClose(one));
+    CHECK(zero.allClose(one, 0, 1));
+    return check::result();
+}
@@ -0,0 +1,123 @@
+#include "Check.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    size_t allocations = 0;
+}
+
+void* operator new(size_t bytes)
+{
+    ++allocations;
+    if (void* p = std::malloc(bytes ? bytes : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+static void moves()
+{
+    static_assert(std::is_nothrow_move_constructible_v<Mat<double>>);
+    static_assert(std::is_nothrow_move_assignable_v<Mat<double>>);
+    static_assert(std::is_nothrow_move_constructible_v<Mat<float, Tensor::Blocked<>>>);
+
+    Mat<double> a = check::random<double>(64, 64);
+    const double* storage = a.data();
+    const size_t before = allocations;
+    Mat<double> b(std::move(a));
+    CHECK(allocations == before);
+    CHECK(b.data() == storage);
+
+    Mat<double> c(2, 2);
+    const size_t beforeAssign = allocations;
+    c = std::move(b);
+    CHECK(allocations == beforeAssign);
+    CHECK(c.data() == storage);
+
+    Mat<double> d(3, 3);
+    const size_t beforeSwap = allocations;
+    std::swap(c, d);
+    CHECK(allocations == beforeSwap);
+    CHECK(d.data() == storage && d.rowCount() == 64 && c.rowCount() == 3);
+
+    // The moved-from tensors are empty 0 x 0 tensors, and can be assigned to again.
+    CHECK(a.rowCount() == 0 && a.colCount() == 0 && a.leadingDim() == 0 && a.size() == 0);
+    CHECK(b.rowCount() == 0 && b.leadingDim() == 0 && a == b);
+    CHECK_THROWS(std::out_of_range, std::as_const(a)(2, 2));
+    CHECK_THROWS(std::out_of_range, a(0, 0));
+    a = Mat<double>(1, 1);
+    CHECK(a.size() == 1);
+
+    Mat<int, ColMajor> small{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+    Mat<int, ColMajor> taken(std::move(small));
+    CHECK(taken(2, 2) == 9 && small.rowCount() == 0 && small.colCount() == 0);
+    CHECK_THROWS(std::out_of_range, std::as_const(small)(2, 2));
+    Mat<int, ColMajor> target(2, 2);
+    target = std::move(taken);
+    CHECK(target(1, 0) == 4 && taken.size() == 0 && !(taken == target));
+    Mat<int, ColMajor>& self = target;
+    target = std::move(self);
+    CHECK(target.rowCount() == 3 && target(2, 2) == 9);
+    small = Mat<int, ColMajor>(3, 3);
+    CHECK(small.rowCount() == 3 && small(2, 2) == 0);
+}
+
+static void buffers()
+{
+    std::vector<double> v{0, 1, 2, 3, 4, 5};
+    const double* p = v.data();
+    Mat<double> adopted(2, 3, std::move(v));
+    CHECK(adopted.data() == p && adopted(1, 2) == 5);
+
+    Mat<double, ColMajor> col(2, 3, std::vector<double>{0, 1, 2, 3, 4, 5});
+    CHECK(col(1, 0) == 1 && col(0, 1) == 2);
+    CHECK_THROWS(std::runtime_error, Mat<double>(2, 2, std::vector<double>(5)));
+    CHECK_THROWS(std::invalid_argument, Mat<double>(0, 2));
+
+    Mat<int> m{{1, 2, 3}, {4, 5, 6}};
+    CHECK(m.rowCount() == 2 && m.colCount() == 3 && m(1, 0) == 4);
+    CHECK_THROWS(std::runtime_error, Mat<int>{{1, 2}, {3}});
+    Mat<int, Tensor::Blocked<>> blocked{{1, 2}, {3, 4}};
+    CHECK(blocked(1, 1) == 4);
+
+    // Copying constructors check the length they are given.
+    const double raw[6] = {0, 1, 2, 3, 4, 5};
+    CHECK(Mat<double>(2, 3, raw, 6) == adopted);
+    CHECK_THROWS(std::runtime_error, Mat<double>(2, 3, raw, 5));
+    CHECK_THROWS(std::invalid_argument, Mat<double>(2, 3, static_cast<const double*>(nullptr), 6));
+    static_assert(!std::is_constructible_v<Mat<double>, size_t, size_t, std::nullptr_t, size_t>);
+    static_assert(!std::is_constructible_v<Mat<double>, size_t, size_t, int>);
+    CHECK((Mat<double>(2, 3, {0, 1, 2, 3, 4, 5}) == adopted));
+    CHECK_THROWS(std::runtime_error, Mat<double>(2, 2, {0}));
+    CHECK((Mat<double, Tensor::Blocked<4>>(1, 1, {7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0})(0, 0) == 7));
+    CHECK(Mat<double>(2, 3, Tensor::LeadingDim{4}).rowCount() == 2);
+#if defined(__cpp_lib_span)
+    const std::vector<double> source{0, 1, 2, 3, 4, 5};
+    CHECK(Mat<double>(2, 3, source) == adopted && source.size() == 6);
+    CHECK_THROWS(std::runtime_error, Mat<double>(3, 3, std::span<const double>(source)));
+#endif
+
+    const int* q = m.data();
+    std::vector<int> released = m.release();
+    CHECK(released.data() == q && released.size() == 6 && m.rowCount() == 0);
+    m = Mat<int>(1, 1);
+    CHECK(m.size() == 1);
+}
+
+int main()
+{
+    moves();
+    buffers();
+    return check::result();
+}
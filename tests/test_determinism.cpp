@@ -0,0 +1,86 @@
+#include "Check.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    size_t largestAllocation = 0;
+}
+
+void* operator new(size_t bytes)
+{
+    largestAllocation = std::max(largestAllocation, bytes);
+    if (void* p = std::malloc(bytes ? bytes : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+// Out of line, or GCC pairs the inlined free() with the library's operator new and warns.
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+using Tensor::GemmPath;
+template<typename T> using Mat = Tensor::Tensor<T>;
+
+/// Element-wise reductions agree bit for bit across thread counts.
+static void reductions()
+{
+    const Mat<float> v = check::random<float>(3001, 700, 1);
+    const Mat<float> w = check::random<float>(3001, 700, 2);
+    Tensor::config::deterministic = true;
+    Tensor::config::parallelThreshold = 4096;
+    Tensor::config::threadCount = 1;
+    const float sum = v.sum(), dot = v.dot(w);
+    for (size_t threads : {3, 8})
+    {
+        Tensor::config::threadCount = threads;
+        CHECK(v.sum() == sum && v.dot(w) == dot);
+    }
+    Tensor::config::deterministic = false;
+    CHECK(std::fabs(v.sum() - sum) < 1e-2f);
+}
+
+/// A product split along K: bit-identical for any thread count, within one partial per thread of scratch.
+static void splitK()
+{
+    const size_t M = 40, N = 50, K = 50000;
+    const Mat<double> a = check::random<double>(M, K, 3);
+    const Mat<double> b = check::random<double>(K, N, 4);
+    const Mat<double> expected = check::naiveProduct(a, b);
+    Tensor::config::gemmPath = GemmPath::SplitK;
+
+    for (bool deterministic : {false, true})
+    {
+        Tensor::config::deterministic = deterministic;
+        Tensor::config::threadCount = 1;
+        const Mat<double> one = a * b;
+        CHECK(check::maxDiff(one, expected) < 1e-9);
+        for (size_t threads : {3, 8})
+        {
+            Tensor::config::threadCount = threads;
+            const Mat<double> many = a * b;
+            CHECK(check::maxDiff(many, expected) < 1e-9);
+            if (deterministic)
+                CHECK(many == one);
+        }
+    }
+
+    // 49 slices of deterministicKSlice; a partial per slice would take 49 * M * N elements.
+    largestAllocation = 0;
+    Tensor::config::deterministic = true;
+    Tensor::config::threadCount = 8;
+    (void)(a * b);
+    CHECK(largestAllocation < 49 * M * N * sizeof(double) / 2);
+    Tensor::config::gemmPath = GemmPath::Auto;
+}
+
+int main()
+{
+    // The pool is sized on first use; later threadCount values only change the chunking.
+    Tensor::config::threadCount = 8;
+    reductions();
+    splitK();
+    return check::result();
+}
@@ -0,0 +1,74 @@
+#include "Check.hpp"
+
+#include <cstdint>
+#include <functional>
+
+using Tensor::Blocked;
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+/// Vectorized operations against a scalar loop, on lengths that leave every possible tail.
+template<typename T, typename Layout>
+static void sameAsScalar(size_t m, size_t n)
+{
+    const Mat<T, Layout> a = check::random<T, Layout>(m, n, m * 131 + n);
+    Mat<T, Layout> b = check::random<T, Layout>(m, n, m * 7 + n + 1);
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+            if (b(i, j) == T{})
+                b(i, j) = T{3};
+
+    const Mat<T, Layout> sum = a.elementWiseOp(b, std::plus<T>());
+    const Mat<T, Layout> difference = a.elementWiseOp(b, std::minus<>());
+    const Mat<T, Layout> product = a.elementWiseOp(b, std::multiplies<T>());
+    const Mat<T, Layout> quotient = a.elementWiseOp(b, std::divides<T>());
+    const Mat<T, Layout> scaled = a * T{3};
+    Mat<T, Layout> filled(m, n);
+    filled.fill(T{5});
+
+    bool same = true;
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+            same = same && sum(i, j) == static_cast<T>(a(i, j) + b(i, j))
+                 && difference(i, j) == static_cast<T>(a(i, j) - b(i, j))
+                 && product(i, j) == static_cast<T>(a(i, j) * b(i, j))
+                 && quotient(i, j) == static_cast<T>(a(i, j) / b(i, j))
+                 && scaled(i, j) == static_cast<T>(a(i, j) * T{3})
+                 && filled(i, j) == T{5};
+    CHECK(same);
+}
+
+template<typename T>
+static void allShapes()
+{
+    for (size_t m : {1, 3, 17, 100})
+        for (size_t n : {1, 5, 33, 64, 257})
+        {
+            sameAsScalar<T, RowMajor>(m, n);
+            sameAsScalar<T, ColMajor>(m, n);
+            sameAsScalar<T, Blocked<8>>(m, n);
+        }
+}
+
+static void allTypes()
+{
+    allShapes<float>();
+    allShapes<double>();
+    allShapes<int>();
+    allShapes<uint32_t>();
+    allShapes<int64_t>();
+    allShapes<short>();
+}
+
+int main()
+{
+    allTypes();
+
+    // The same again split across threads, and with streaming stores on every size.
+    Tensor::config::threadCount = 4;
+    Tensor::config::parallelThreshold = 10;
+    Tensor::config::nonTemporalBytes = 0;
+    allTypes();
+    return check::result();
+}
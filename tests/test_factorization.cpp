@@ -0,0 +1,145 @@
+#include "Check.hpp"
+#include "../Factorization.hpp"
+
+#include <type_traits>
+#include <vector>
+
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+/// Diagonally dominant n x n matrix, comfortably nonsingular.
+template<typename T, typename Layout>
+static Mat<T, Layout> dominant(size_t n, uint64_t seed)
+{
+    Mat<T, Layout> a = check::random<T, Layout>(n, n, seed);
+    for (size_t i = 0; i < n; ++i)
+        a(i, i) += static_cast<T>(n);
+    return a;
+}
+
+/// |x - y| relative to |y|.
+static double relative(double x, double y) { return std::fabs(x - y) / std::max(std::fabs(y), 1e-300); }
+
+/// Rank-k updates of LU agree with factoring A + U V^T afresh, over repeated updates.
+template<typename T, typename Layout>
+static void lu()
+{
+    const double tolerance = sizeof(T) == sizeof(float) ? 1e-3 : 1e-9;
+    const size_t n = 120;
+    Mat<T, Layout> a = dominant<T, Layout>(n, 1);
+    const Mat<T, Layout> rhs = check::random<T, Layout>(n, 3, 2);
+    Tensor::LU<T> updated(a);
+    for (uint64_t round = 0; round < 6; ++round)
+    {
+        const Mat<T, Layout> u = check::random<T, Layout>(n, 1 + (round % 3), 10 + round);
+        const Mat<T, Layout> v = check::random<T, Layout>(n, 1 + (round % 3), 20 + round);
+        updated.update(u, v);
+        a = a + (u * v.transpose());
+        const Tensor::LU<T> fresh(a);
+        CHECK(check::maxDiff(updated.solve(rhs), fresh.solve(rhs)) < tolerance);
+        if (std::is_same<T, double>::value)   // about n^n, past the range of float
+            CHECK(relative(updated.determinant(), fresh.determinant()) < 1e-12);
+    }
+
+    // An update that cancels the first pivot falls back to factoring with pivoting.
+    Mat<T, Layout> id = Mat<T, Layout>::eye(4);
+    Mat<T, Layout> u(4, 1), v(4, 1);
+    u(0, 0) = 1;
+    u(1, 0) = 1;
+    v(0, 0) = -1;
+    v(1, 0) = 1;
+    Tensor::LU<T> pivoted(id);
+    pivoted.update(u, v);
+    const Mat<T, Layout> b = check::random<T, Layout>(4, 1, 3);
+    CHECK(!pivoted.isSingular());
+    CHECK(check::maxDiff(pivoted.solve(b), Tensor::LU<T>(id + (u * v.transpose())).solve(b)) < tolerance);
+    CHECK_THROWS(std::runtime_error, pivoted.update(Mat<T, Layout>(3, 1), v));
+}
+
+/// Cholesky updates and downdates agree with factoring A +- X X^T afresh.
+template<typename Layout>
+static void cholesky()
+{
+    const size_t n = 100;
+    const Mat<double, Layout> m = check::random<double, Layout>(n, n, 4);
+    Mat<double, Layout> a = m.transpose() * m;
+    for (size_t i = 0; i < n; ++i)
+        a(i, i) += static_cast<double>(n);
+    const Mat<double, Layout> rhs = check::random<double, Layout>(n, 2, 5);
+    const Mat<double, Layout> x = check::random<double, Layout>(n, 4, 6);
+    const Mat<double, Layout> added = a + (x * x.transpose());
+
+    Tensor::Cholesky<double> factor(a);
+    factor.update(x);
+    CHECK(check::maxDiff(factor.solve(rhs), Tensor::Cholesky<double>(added).solve(rhs)) < 1e-10);
+    CHECK(relative(factor.determinant(), Tensor::Cholesky<double>(added).determinant()) < 1e-8);
+    factor.downdate(x);
+    CHECK(check::maxDiff(factor.solve(rhs), Tensor::Cholesky<double>(a).solve(rhs)) < 1e-10);
+
+    // A downdate that loses definiteness throws and leaves the factor as it was.
+    const Mat<double, Layout> before = factor.solve(rhs);
+    Mat<double, Layout> big(n, 1);
+    big(0, 0) = 1e3;
+    CHECK_THROWS(std::runtime_error, factor.downdate(big));
+    CHECK(factor.solve(rhs) == before);
+}
+
+/// QR updates agree with factoring A + U V^T afresh, for tall and square A.
+template<typename Layout>
+static void qr(size_t rows, size_t cols)
+{
+    Mat<double, Layout> a = check::random<double, Layout>(rows, cols, 7);
+    for (size_t i = 0; i < cols; ++i)
+        a(i, i) += 4;
+    const Mat<double, Layout> rhs = check::random<double, Layout>(rows, 2, 8);
+    Tensor::QR<double> updated(a);
+    for (uint64_t round = 0; round < 4; ++round)
+    {
+        const Mat<double, Layout> u = check::random<double, Layout>(rows, 2, 30 + round);
+        const Mat<double, Layout> v = check::random<double, Layout>(cols, 2, 40 + round);
+        updated.update(u, v);
+        a = a + (u * v.transpose());
+        CHECK(check::maxDiff(updated.solve(rhs), Tensor::QR<double>(a).solve(rhs)) < 1e-9);
+    }
+    CHECK_THROWS(std::runtime_error, updated.update(Mat<double, Layout>(rows + 1, 1), Mat<double, Layout>(cols, 1)));
+}
+
+/// Sherman-Morrison-Woodbury agrees with inverting A + U V^T afresh.
+template<typename Layout>
+static void inverse()
+{
+    const size_t n = 90;
+    Mat<double, Layout> a = dominant<double, Layout>(n, 9);
+    Mat<double, Layout> inv = Tensor::LU<double>(a).solve(Mat<double, Layout>::eye(n));
+    for (uint64_t round = 0; round < 5; ++round)
+    {
+        const Mat<double, Layout> u = check::random<double, Layout>(n, 1 + round, 50 + round);
+        const Mat<double, Layout> v = check::random<double, Layout>(n, 1 + round, 60 + round);
+        Tensor::updateInverse(inv, u, v);
+        a = a + (u * v.transpose());
+        CHECK(check::maxDiff(inv, Tensor::LU<double>(a).solve(Mat<double, Layout>::eye(n))) < 1e-10);
+    }
+
+    // I + e0 (-e0)^T is singular.
+    Mat<double, Layout> id = Mat<double, Layout>::eye(3);
+    Mat<double, Layout> u(3, 1), v(3, 1);
+    u(0, 0) = 1;
+    v(0, 0) = -1;
+    CHECK_THROWS(std::runtime_error, Tensor::updateInverse(id, u, v));
+    CHECK_THROWS(std::runtime_error, Tensor::updateInverse(id, Mat<double, Layout>(2, 1), v));
+}
+
+int main()
+{
+    lu<double, RowMajor>();
+    lu<double, ColMajor>();
+    lu<float, RowMajor>();
+    cholesky<RowMajor>();
+    cholesky<ColMajor>();
+    qr<RowMajor>(150, 80);
+    qr<ColMajor>(60, 60);
+    inverse<RowMajor>();
+    inverse<ColMajor>();
+    return check::result();
+}
@@ -0,0 +1,76 @@
+#include "Check.hpp"
+
+#include <set>
+
+using Tensor::ColMajor;
+using Tensor::GemmPath;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+namespace
+{
+    std::set<GemmPath> taken;
+}
+
+static void observe(const Tensor::GemmDecision& decision) { taken.insert(decision.path); }
+
+/// (*) and transposeMultiply() on one forced kernel agree with the triple loop.
+template<typename T, typename Layout>
+static void sameAsNaive(GemmPath path, size_t M, size_t N, size_t K)
+{
+    const double tolerance = (sizeof(T) == 4 ? 1e-5 : 1e-12) * static_cast<double>(K);
+    Mat<T, Layout> a = check::random<T, Layout>(M, K, M + K);
+    const Mat<T, Layout> b = check::random<T, Layout>(K, N, K + N);
+    if (path == GemmPath::SparseA)
+        for (size_t i = 0; i < M; ++i)
+            for (size_t k = 0; k < K; ++k)
+                if ((i + k) % 3 != 0)
+                    a(i, k) = 0;
+    const Mat<T, Layout> expected = check::naiveProduct(a, b);
+    const Mat<T, Layout> at = a.transpose();
+
+    Tensor::config::gemmPath = path;
+    const Mat<T, Layout> product = a * b;
+    const Mat<T, Layout> reduced = at.transposeMultiply(b);
+    Tensor::config::gemmPath = GemmPath::Auto;
+    CHECK(check::maxDiff(product, expected) < tolerance);
+    CHECK(check::maxDiff(reduced, expected) < tolerance);
+}
+
+template<typename T, typename Layout>
+static void allShapes(GemmPath path)
+{
+    const size_t shapes[][3] = {
+        {1, 1, 1}, {13, 17, 9}, {30, 1, 40},       // small, generated-kernel and matrix-vector sizes
+        {3000, 8, 16}, {16, 8, 3000},              // tall-skinny A and a tall A^T * B reduction
+        {4, 2000, 300}, {130, 70, 300},            // short-wide and ragged against every block size
+        {200, 1, 700}};
+    for (const auto& s : shapes)
+        sameAsNaive<T, Layout>(path, s[0], s[1], s[2]);
+}
+
+int main()
+{
+    Tensor::config::threadCount = 8;
+    Tensor::config::gemmObserver = observe;
+    Tensor::config::jitMinUses = 0;   // a forced generated kernel runs on first use
+    const GemmPath paths[] = {GemmPath::Auto, GemmPath::Unpacked, GemmPath::Jit, GemmPath::Gemv, GemmPath::SparseA,
+                              GemmPath::Packed, GemmPath::ColumnParallel, GemmPath::SplitK};
+    for (GemmPath path : paths)
+    {
+        taken.clear();
+        allShapes<float, RowMajor>(path);
+        allShapes<double, RowMajor>(path);
+        allShapes<double, ColMajor>(path);
+        // Each kernel ran at least once; shapes it can't run fell back without error.
+        CHECK(path == GemmPath::Auto || taken.count(path) == 1
+              || (path == GemmPath::Jit && !Tensor::detail::jit::supported()));
+    }
+
+    // So do the kernels the deterministic mode picks, with K cut into fixed slices.
+    Tensor::config::deterministic = true;
+    Tensor::config::deterministicKSlice = 256;
+    allShapes<double, RowMajor>(GemmPath::Auto);
+    Tensor::config::deterministic = false;
+    return check::result();
+}
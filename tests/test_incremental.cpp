@@ -0,0 +1,128 @@
+#include "Check.hpp"
+#include "../IncrementalProduct.hpp"
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+/// After every kind of write, the cached product equals a fresh a * b.
+template<typename T, typename Layout>
+static void mixedWrites(bool tracked)
+{
+    const double tolerance = std::is_same<T, float>::value ? 1e-3 : std::is_same<T, double>::value ? 1e-9 : 0;
+    Mat<T, Layout> a = check::random<T, Layout>(120, 90, 1);
+    Mat<T, Layout> b = check::random<T, Layout>(90, 70, 2);
+    a.trackWrites(tracked);
+    b.trackWrites(tracked);
+    Tensor::IncrementalProduct<T, Layout> p(a, b);
+    check::Values values(3);
+    // Wide enough that an integer write rarely stores the value already there.
+    auto value = [&] { return static_cast<T>(values.next() * (std::is_integral<T>::value ? 1000 : 8)); };
+
+    for (size_t round = 0; round < 12; ++round)
+    {
+        switch (round % 6)
+        {
+        case 0:     // scattered elements of both operands
+            for (size_t e = 0; e < 5; ++e)
+            {
+                a((e * 37 + round) % 120, (e * 11) % 90) = value();
+                b.set((e * 13) % 90, (e * 29 + round) % 70, value());
+            }
+            break;
+        case 1:     // one column of A
+            for (size_t i = 0; i < 120; ++i)
+                a(i, round) = value();
+            break;
+        case 2:     // whole rows of A and columns of B
+            for (size_t j = 0; j < 90; ++j)
+                a.set(round, j, value());
+#if defined(__cpp_lib_span)
+            if constexpr (std::is_same<Layout, RowMajor>::value)
+                for (T& x : a.row(round + 1))
+                    x = value();
+            else
+                for (T& x : b.col(round))
+                    x = value();
+#endif
+            break;
+        case 3:     // a block of B
+            for (size_t k = 10; k < 20; ++k)
+                for (size_t j = 30; j < 45; ++j)
+                    b(k, j) = value();
+            break;
+        case 4:     // bulk write
+            a.fill(static_cast<T>(round));
+            break;
+        default:    // nothing but a write of the value already there
+            b(5, 5) = static_cast<T>(std::as_const(b)(5, 5));
+            break;
+        }
+        CHECK(check::maxDiff(p.update(), check::naiveProduct(a, b)) <= tolerance);
+    }
+    CHECK(check::maxDiff(p.refresh(), check::naiveProduct(a, b)) <= tolerance);
+    CHECK(p.stats().full >= 1 + (tracked ? 0 : 1));
+    if (tracked)
+        CHECK(p.stats().rows > 0 && p.stats().deltas > 0);
+}
+
+/// Reads through the non-const accessors mark lines written but leave the product alone.
+static void readsCostNothing()
+{
+    Mat<double> a = check::random<double>(200, 150, 4);
+    Mat<double> b = check::random<double>(150, 120, 5);
+    a.trackWrites();
+    b.trackWrites();
+    Tensor::IncrementalProduct<double> p(a, b);
+    const Tensor::IncrementalStats before = p.stats();
+    const Mat<double> product = p.product();
+
+    const uint64_t counter = Tensor::detail::stampCounter().load();
+    double sum = 0;
+    for (size_t i = 0; i < 200; ++i)
+        for (size_t j = 0; j < 150; ++j)
+            sum += a(i, j);
+    for (size_t k = 0; k < 150; ++k)
+        sum += b(k, k % 120);
+    CHECK(Tensor::detail::stampCounter().load() == counter);   // no atomic increment per access
+    CHECK(std::isfinite(sum));
+
+    CHECK(p.update() == product);
+    CHECK(p.stats().updates == before.updates && p.stats().full == before.full);
+
+    // One real write among the reads is the only one applied.
+    a(7, 3) += 1;
+    CHECK(check::maxDiff(p.update(), a * b) < 1e-9);
+    CHECK(p.stats().updates == before.updates + 1 && p.stats().rows == 0 && p.stats().full == before.full);
+}
+
+/// writeStamp() orders writes: later ones are reported, earlier ones aren't.
+static void stamps()
+{
+    Mat<float> m(6, 5);
+    m.trackWrites();
+    const uint64_t s = Mat<float>::writeStamp();
+    m(1, 2) = 1;
+    m.set(4, 0, 2);
+    const Tensor::WrittenLines w = m.writtenSince(s);
+    CHECK((w.rows == std::vector<size_t>{1, 4}) && (w.cols == std::vector<size_t>{0, 2}));
+    const uint64_t t = Mat<float>::writeStamp();
+    CHECK(t > s && m.writtenSince(t).rows.empty());
+    m(3, 3) = 5;
+    CHECK(m.writtenSince(t).rows == std::vector<size_t>{3});
+}
+
+int main()
+{
+    mixedWrites<double, RowMajor>(true);
+    mixedWrites<double, ColMajor>(true);
+    mixedWrites<int, RowMajor>(true);
+    mixedWrites<float, RowMajor>(false);
+    readsCostNothing();
+    stamps();
+    return check::result();
+}
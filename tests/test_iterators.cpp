@@ -0,0 +1,96 @@
+#include "Check.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#endif
+
+using Tensor::Blocked;
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+#if defined(__cpp_lib_ranges)
+static_assert(std::ranges::contiguous_range<Mat<float>>);
+static_assert(std::ranges::sized_range<const Mat<double, ColMajor>>);
+#endif
+
+/// Reads through the const paths leave version() alone; the non-const ones count as writes.
+static void readsAndWrites()
+{
+    Mat<float> a = check::random<float>(100, 37, 1);
+    const uint64_t v = a.version();
+    const float total = std::accumulate(a.cbegin(), a.cend(), 0.0f);
+    CHECK(std::fabs(total - a.sum()) < 1e-3f);
+    CHECK(a.cdata() == std::as_const(a).data() && std::as_const(a)(3, 4) == a.cdata()[(3 * 37) + 4]);
+    for (float x : std::as_const(a))
+        (void)x;
+    CHECK(a.version() == v);
+
+    std::transform(a.begin(), a.end(), a.begin(), [](float x) { return 2 * x; });
+    CHECK(a.version() != v);
+    const uint64_t w = a.version();
+    (void)a.data();
+    CHECK(a.version() != w);
+    CHECK(&a(0, 0) == a.cdata());
+
+    std::sort(a.begin(), a.end());
+    CHECK(std::is_sorted(a.cbegin(), a.cend()));
+
+    // Padded storage has no single range.
+    Mat<float, Blocked<>> blocked(40, 40);
+    CHECK_THROWS(std::logic_error, blocked.begin());
+    CHECK_THROWS(std::logic_error, std::as_const(blocked).cbegin());
+    Mat<float> padded(3, 5, Tensor::LeadingDim{8});
+    CHECK(!padded.isContiguous());
+    CHECK_THROWS(std::logic_error, padded.end());
+}
+
+static void spans()
+{
+#if defined(__cpp_lib_span)
+    Mat<float> a = check::random<float>(10, 6, 2);
+    const uint64_t v = a.version();
+    CHECK(std::as_const(a).row(3).size() == 6 && std::as_const(a).row(3)[1] == a.cdata()[(3 * 6) + 1]);
+    CHECK(a.version() == v);
+    auto row = a.row(3);
+    row[0] = 42;
+    CHECK(a(3, 0) == 42 && a.version() != v);
+    CHECK_THROWS(std::out_of_range, a.row(10));
+
+    Mat<int, ColMajor> c(4, 5);
+    for (int& x : c.col(2))
+        x = 7;
+    CHECK(c(3, 2) == 7 && c(3, 1) == 0);
+    int total = 0;
+    for (int x : std::as_const(c))
+        total += x;
+    CHECK(total == 28);
+
+    // Rows of a padded tensor are still contiguous spans.
+    Mat<double> padded(3, 5, Tensor::LeadingDim{8});
+    for (size_t i = 0; i < 3; ++i)
+        for (double& x : padded.row(i))
+            x = static_cast<double>(i);
+    CHECK(padded(2, 4) == 2 && padded.sum() == 15);
+#endif
+#if defined(__cpp_lib_ranges)
+    const Mat<float> r = check::random<float>(20, 20, 3);
+    auto positive = r | std::views::filter([](float x) { return x > 0; });
+    size_t count = 0;
+    for (size_t i = 0; i < 20; ++i)
+        for (size_t j = 0; j < 20; ++j)
+            count += r(i, j) > 0;
+    CHECK(static_cast<size_t>(std::ranges::distance(positive)) == count);
+#endif
+}
+
+int main()
+{
+    readsAndWrites();
+    spans();
+    return check::result();
+}
@@ -0,0 +1,115 @@
+#include "Check.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using Tensor::GemmPath;
+namespace jit = Tensor::detail::jit;
+
+namespace
+{
+    GemmPath taken = GemmPath::Auto;
+}
+
+static void observe(const Tensor::GemmDecision& decision) { taken = decision.path; }
+
+/// C (M x N, ldc) += A (M x K, lda) * B (K x N, ldb) on one forced kernel, from the same start C.
+template<typename T>
+static std::vector<T> run(GemmPath path, size_t M, size_t N, size_t K, size_t lda, size_t ldb, size_t ldc,
+                          const std::vector<T>& a, const std::vector<T>& b)
+{
+    std::vector<T> c(M * ldc);
+    for (size_t e = 0; e < c.size(); ++e)
+        c[e] = static_cast<T>(e % 7);
+    Tensor::config::gemmPath = path;
+    Tensor::detail::gemm<T>(M, N, K, a.data(), lda, b.data(), ldb, c.data(), ldc);
+    Tensor::config::gemmPath = GemmPath::Auto;
+    return c;
+}
+
+/// Generated kernels agree with the packed kernel on ragged shapes and padded leading dimensions.
+template<typename T>
+static void sameAsPacked(size_t M, size_t N, size_t K, size_t pad)
+{
+    const size_t lda = K + pad, ldb = N + pad, ldc = N + (2 * pad);
+    check::Values values(M * N + K);
+    std::vector<T> a(M * lda), b(K * ldb);
+    for (T& x : a)
+        x = static_cast<T>(values.next());
+    for (T& x : b)
+        x = static_cast<T>(values.next());
+
+    const std::vector<T> packed = run<T>(GemmPath::Packed, M, N, K, lda, ldb, ldc, a, b);
+    const std::vector<T> generated = run<T>(GemmPath::Jit, M, N, K, lda, ldb, ldc, a, b);
+    CHECK(taken == GemmPath::Jit || !jit::supported());
+    double worst = 0;
+    bool untouched = true;
+    for (size_t i = 0; i < M; ++i)
+        for (size_t j = 0; j < ldc; ++j)
+        {
+            const size_t e = (i * ldc) + j;
+            if (j < N)
+                worst = std::max(worst, std::fabs(static_cast<double>(generated[e]) - static_cast<double>(packed[e])));
+            else
+                untouched = untouched && generated[e] == static_cast<T>(e % 7);   // masked stores stay inside the row
+        }
+    CHECK(worst < (sizeof(T) == 4 ? 1e-4 : 1e-12) && untouched);
+}
+
+/// A shape runs on the compiled kernels until it has come up config::jitMinUses times, and never in deterministic mode.
+static void warmUp()
+{
+    const size_t M = 11, N = 19, K = 5;
+    const std::vector<float> a(M * K, 1.0f), b(K * N, 2.0f);
+    Tensor::config::jitMinUses = 4;
+    for (size_t use = 1; use <= 6; ++use)
+    {
+        run<float>(GemmPath::Auto, M, N, K, K, N, N, a, b);
+        CHECK(taken == (use >= 4 && jit::supported() ? GemmPath::Jit : GemmPath::Unpacked));
+    }
+
+    Tensor::config::deterministic = true;
+    run<float>(GemmPath::Auto, M, N, K, K, N, N, a, b);
+    CHECK(taken == GemmPath::Unpacked);
+    run<float>(GemmPath::Jit, M, N, K, K, N, N, a, b);
+    CHECK(taken != GemmPath::Jit);
+    Tensor::config::deterministic = false;
+
+    // Shapes that don't come back often enough are never compiled.
+    Tensor::config::jitMinUses = 3;
+    for (size_t round = 0; round < 2; ++round)
+        for (size_t n = 1; n <= 8; ++n)
+        {
+            run<float>(GemmPath::Auto, 3, n, 4, 4, n + 2, n, std::vector<float>(12), std::vector<float>(4 * (n + 2)));
+            CHECK(taken != GemmPath::Jit);
+        }
+}
+
+int main()
+{
+    Tensor::config::gemmObserver = observe;
+    warmUp();
+    Tensor::config::jitMinUses = 0;   // forced kernels below are generated on first use
+    for (size_t M : {1, 5, 6, 7, 13})
+        for (size_t N : {1, 3, 8, 9, 17, 31})
+            for (size_t K : {1, 2, 7, 32})
+                for (size_t pad : {0, 3})
+                {
+                    sameAsPacked<float>(M, N, K, pad);
+                    sameAsPacked<double>(M, N, K, pad);
+                }
+    sameAsPacked<float>(64, 16, 32, 1);
+    sameAsPacked<double>(32, 64, 16, 5);
+
+    // Offsets past a 32-bit displacement are left to the compiled kernels.
+    const size_t limit = static_cast<size_t>(INT32_MAX);
+    CHECK(jit::addressable<float>(8, limit / 4 / 8, 8) && !jit::addressable<float>(8, limit / 4 / 7, 8));
+    CHECK(!jit::addressable<double>(2, limit / 8, 1) && jit::addressable<double>(1, limit / 8, 1));
+    CHECK(!jit::eligible<float>(4, 4, 4, size_t{1} << 30, 4, 4));
+    CHECK(!jit::eligible<float>(4, 4, 4, 4, size_t{1} << 30, 4));
+    CHECK(!jit::eligible<double>(4, 4, 4, 4, 4, size_t{1} << 28));
+    CHECK(jit::kernel<float>(4, 4, 4, size_t{1} << 30, 4, 4) == nullptr);
+    CHECK(jit::eligible<float>(4, 4, 4, 4, 4, 4) == jit::supported());
+    CHECK(!jit::eligible<int>(4, 4, 4, 4, 4, 4));
+    return check::result();
+}
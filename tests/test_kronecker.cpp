@@ -0,0 +1,80 @@
+#include "Check.hpp"
+#include "../Kronecker.hpp"
+
+using Tensor::Blocked;
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+template<typename Layout>
+static void products(const Mat<double, Layout>& a, const Mat<double, Layout>& b)
+{
+    const Mat<double, Layout> k = a.kron(b);
+    CHECK(k.rowCount() == a.rowCount() * b.rowCount() && k.colCount() == a.colCount() * b.colCount());
+    bool blocks = true;
+    for (size_t i = 0; i < a.rowCount(); ++i)
+        for (size_t j = 0; j < a.colCount(); ++j)
+            for (size_t p = 0; p < b.rowCount(); ++p)
+                for (size_t q = 0; q < b.colCount(); ++q)
+                    blocks = blocks && k((i * b.rowCount()) + p, (j * b.colCount()) + q) == a(i, j) * b(p, q);
+    CHECK(blocks);
+
+    const Tensor::KroneckerView<double, Layout> view(a, b);
+    CHECK(view.rowCount() == k.rowCount() && view.colCount() == k.colCount());
+    CHECK(view.materialize() == k);
+    const Mat<double, Layout> x = check::random<double, Layout>(k.colCount(), 3, 7);
+    CHECK((view * x).allClose(k * x, 1e-12, 1e-12));
+    CHECK_THROWS(std::runtime_error, view * Mat<double, Layout>(k.colCount() + 1, 1));
+}
+
+template<typename Layout>
+static void allProducts()
+{
+    products(check::random<double, Layout>(2, 3, 1), check::random<double, Layout>(4, 5, 2));
+    products(check::random<double, Layout>(1, 1, 3), check::random<double, Layout>(3, 2, 4));
+    products(check::random<double, Layout>(5, 2, 5), check::random<double, Layout>(1, 7, 6));
+
+    using M = Mat<double, Layout>;
+    M u(3, 1), v(1, 4);
+    for (size_t i = 0; i < 3; ++i)
+        u(i, 0) = static_cast<double>(i) + 1;
+    for (size_t j = 0; j < 4; ++j)
+        v(0, j) = static_cast<double>(j) - 1;
+    const M outer = M::outer(u, v);
+    bool rankOne = outer.rowCount() == 3 && outer.colCount() == 4;
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 4; ++j)
+            rankOne = rankOne && outer(i, j) == u(i, 0) * v(0, j);
+    CHECK(rankOne);
+    CHECK(M::outer(u, v.transpose()) == outer);
+    CHECK_THROWS(std::invalid_argument, M::outer(M(2, 2), v));
+
+    const M b = check::random<double, Layout>(4, 5, 8);
+    const M h = b.hadamard(b);
+    CHECK(h(3, 4) == b(3, 4) * b(3, 4) && h(0, 0) == b(0, 0) * b(0, 0));
+}
+
+/// Operands whose lines are padded past their length.
+static void padded()
+{
+    Mat<double> a(2, 3, Tensor::LeadingDim{8});
+    Mat<double> b(3, 2, Tensor::LeadingDim{5});
+    const Mat<double> denseA = check::random<double>(2, 3, 9);
+    const Mat<double> denseB = check::random<double>(3, 2, 10);
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 3; ++j)
+        {
+            a(i, j) = denseA(i, j);
+            b(j, i) = denseB(j, i);
+        }
+    CHECK(a.kron(b) == denseA.kron(denseB));
+}
+
+int main()
+{
+    allProducts<RowMajor>();
+    allProducts<ColMajor>();
+    allProducts<Blocked<4>>();
+    padded();
+    return check::result();
+}
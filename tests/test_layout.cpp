@@ -0,0 +1,89 @@
+#include "Check.hpp"
+
+#include <functional>
+#include <limits>
+
+using Tensor::Blocked;
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+template<typename Layout>
+static void sameAsRowMajor(size_t m, size_t k, size_t n)
+{
+    const Mat<int> a = check::random<int>(m, k, 1);
+    const Mat<int> b = check::random<int>(k, n, 2);
+    const Mat<int, Layout> al = a.toLayout<Layout>();
+    const Mat<int, Layout> bl = b.toLayout<Layout>();
+
+    CHECK((al * bl).template toLayout<RowMajor>() == check::naiveProduct(a, b));
+    CHECK(al.transpose().template toLayout<RowMajor>() == a.transpose());
+    CHECK((al * 2).template toLayout<RowMajor>() == a * 2);
+    CHECK(al == al.template toLayout<ColMajor>().template toLayout<Layout>());
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < k; ++j)
+            CHECK(al(i, j) == a(i, j));
+
+    // Integer division by the padding would trap, so this also checks padding is never visited.
+    Mat<int, Layout> ones = al;
+    ones.fill(1);
+    CHECK(ones.elementWiseOp(ones, std::divides<int>()) == ones);
+}
+
+/// An infinity must reach neither C's padding nor, through it, the next product that reads C.
+template<size_t Tile>
+static void blockedInfinities()
+{
+    using B = Blocked<Tile>;
+    const size_t n = Tile + 3;
+    Mat<double> a = check::random<double>(n, n, 3);
+    Mat<double> b = check::random<double>(n, n, 4);
+    Mat<double> r = check::random<double>(n, n, 5);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+        {
+            b(i, j) = std::fabs(b(i, j)) + 0.5;
+            r(i, j) = std::fabs(r(i, j)) + 0.5;
+        }
+    a(1, 2) = std::numeric_limits<double>::infinity();
+
+    // Row 1 of C is +inf throughout, every other element finite; nothing is NaN.
+    const Mat<double, B> c = a.toLayout<B>() * b.toLayout<B>();
+    const double* storage = c.data();
+    bool anyNaN = false;
+    for (size_t e = 0; e < Mat<double, B>::storageSize(n, n); ++e)
+        anyNaN = anyNaN || std::isnan(storage[e]);
+    CHECK(!anyNaN);
+    CHECK(std::isinf(c(1, 0)) && c(1, n - 1) > 0);
+
+    const Mat<double, B> next = c * r.toLayout<B>();
+    const Mat<double> expected = check::naiveProduct(c.template toLayout<RowMajor>(), r);
+    bool matches = true;
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            matches = matches && !std::isnan(next(i, j))
+                   && (next(i, j) == expected(i, j) || std::fabs(next(i, j) - expected(i, j)) < 1e-9);
+    CHECK(matches);
+
+    // Padding adopted from a caller's buffer isn't trusted either: the K extent stops at the logical end.
+    Mat<double, B> dirty(n, n, std::vector<double>(Mat<double, B>::storageSize(n, n), std::nan("")));
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            dirty(i, j) = r(i, j);
+    CHECK(check::maxDiff(dirty * b.toLayout<B>(), check::naiveProduct(r, b)) < 1e-9);
+}
+
+int main()
+{
+    const size_t shapes[][3] = {{1, 1, 1}, {3, 5, 7}, {33, 40, 65}, {64, 64, 64}};
+    for (const auto& s : shapes)
+    {
+        sameAsRowMajor<RowMajor>(s[0], s[1], s[2]);
+        sameAsRowMajor<ColMajor>(s[0], s[1], s[2]);
+        sameAsRowMajor<Blocked<8>>(s[0], s[1], s[2]);
+        sameAsRowMajor<Blocked<>>(s[0], s[1], s[2]);
+    }
+    blockedInfinities<4>();
+    blockedInfinities<32>();
+    return check::result();
+}
@@ -0,0 +1,117 @@
+#include "Check.hpp"
+#include "../MatrixFunctions.hpp"
+
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+namespace
+{
+    size_t allocations = 0;
+}
+
+void* operator new(size_t bytes)
+{
+    ++allocations;
+    if (void* p = std::malloc(bytes ? bytes : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+// Out of line, or GCC pairs the inlined free() with the library's operator new and warns.
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+using M = Tensor::Tensor<double>;
+
+/// A row-stochastic matrix, whose powers stay bounded.
+static M markov()
+{
+    M a(3, 3);
+    a(0, 0) = 0.5; a(0, 1) = 0.5;
+    a(1, 1) = 0.3; a(1, 2) = 0.7;
+    a(2, 0) = 1;
+    return a;
+}
+
+static void powers()
+{
+    const M a = markov();
+    M repeated = M::eye(3);
+    for (uint64_t n = 0; n <= 40; ++n)
+    {
+        CHECK(Tensor::pow(a, n).allClose(repeated, 1e-12, 1e-14));
+        repeated = repeated * a;
+    }
+    CHECK(Tensor::pow(a, 0) == M::eye(3));
+    CHECK(Tensor::pow(a, 1) == a);
+    CHECK_THROWS(std::runtime_error, Tensor::pow(M(2, 3), 2));
+
+    // The buffers are allocated once: a thousandfold exponent costs no more allocations than a small one.
+    const M big = check::random<double>(64, 64) * 0.01;
+    const size_t before = allocations;
+    (void)Tensor::pow(big, 3);
+    const size_t small = allocations - before;
+    (void)Tensor::pow(big, 1000);
+    const size_t large = allocations - before - small;
+    CHECK(large <= small);
+}
+
+static void exponentials()
+{
+    // A rotation generator: e^R is the rotation by t.
+    for (double t : {0.001, 0.1, 1.0, 3.0, 30.0})
+    {
+        M r(2, 2);
+        r(0, 1) = -t;
+        r(1, 0) = t;
+        M rotation(2, 2);
+        rotation(0, 0) = rotation(1, 1) = std::cos(t);
+        rotation(0, 1) = -std::sin(t);
+        rotation(1, 0) = std::sin(t);
+        CHECK(Tensor::expm(r).allClose(rotation, 1e-9, 1e-12));
+    }
+
+    // A nilpotent matrix: the series stops at I + N + N^2 / 2.
+    M n(3, 3);
+    n(0, 1) = 2;
+    n(1, 2) = 3;
+    M series = M::eye(3);
+    series(0, 1) = 2;
+    series(1, 2) = 3;
+    series(0, 2) = 3;
+    CHECK(Tensor::expm(n).allClose(series, 1e-12, 1e-12));
+
+    // A diagonal matrix, large enough to need scaling and squaring.
+    M d(4, 4);
+    for (size_t i = 0; i < 4; ++i)
+        d(i, i) = (static_cast<double>(i) * 10) - 15;
+    const M e = Tensor::expm(d);
+    for (size_t i = 0; i < 4; ++i)
+        CHECK(std::fabs((e(i, i) / std::exp(d(i, i))) - 1) < 1e-12);
+
+    Tensor::Tensor<float> f(2, 2);
+    f(0, 1) = -5;
+    f(1, 0) = 5;
+    CHECK(std::fabs(Tensor::expm(f)(0, 0) - std::cos(5.0f)) < 1e-4f);
+
+    // Non-finite input gives NaN throughout rather than an out of range squaring count.
+    for (double bad : {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()})
+    {
+        M x = markov();
+        x(1, 2) = bad;
+        const M y = Tensor::expm(x);
+        bool allNaN = true;
+        for (size_t i = 0; i < 3; ++i)
+            for (size_t j = 0; j < 3; ++j)
+                allNaN = allNaN && std::isnan(y(i, j));
+        CHECK(allNaN);
+    }
+}
+
+int main()
+{
+    powers();
+    exponentials();
+    return check::result();
+}
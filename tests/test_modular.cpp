@@ -0,0 +1,85 @@
+#include "Check.hpp"
+#include "../Modular.hpp"
+
+using Tensor::Blocked;
+using Tensor::ColMajor;
+using Tensor::Modulus;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+/// Full-range 32-bit values, so operands arrive unreduced.
+template<typename Layout>
+static Mat<uint32_t, Layout> words(size_t rows, size_t cols, uint64_t seed)
+{
+    uint64_t state = (seed * 0x9E3779B97F4A7C15ull) | 1;
+    Mat<uint32_t, Layout> m(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            m(i, j) = static_cast<uint32_t>(state >> 32);
+        }
+    return m;
+}
+
+/// Reduces after every multiply-add, which can't overflow.
+template<typename Layout>
+static Mat<uint32_t, Layout> naiveMod(const Mat<uint32_t, Layout>& a, const Mat<uint32_t, Layout>& b, uint64_t p)
+{
+    Mat<uint32_t, Layout> c(a.rowCount(), b.colCount());
+    for (size_t i = 0; i < a.rowCount(); ++i)
+        for (size_t j = 0; j < b.colCount(); ++j)
+        {
+            uint64_t sum = 0;
+            for (size_t k = 0; k < a.colCount(); ++k)
+                sum = (sum + ((a(i, k) % p) * (b(k, j) % p))) % p;
+            c(i, j) = static_cast<uint32_t>(sum);
+        }
+    return c;
+}
+
+template<typename Layout>
+static void sameAsNaive(size_t m, size_t k, size_t n, uint32_t p)
+{
+    const Mat<uint32_t, Layout> a = words<Layout>(m, k, m + k + p);
+    const Mat<uint32_t, Layout> b = words<Layout>(k, n, k + n + p);
+    const Mat<uint32_t, Layout> expected = naiveMod(a, b, p);
+    CHECK(Tensor::multiplyMod(a, b, Modulus(p)) == expected);
+
+    // The same product on the other kernel: 64-bit integers for small moduli, doubles never for large ones.
+    const uint64_t saved = Tensor::config::modularDoubleTerms;
+    Tensor::config::modularDoubleTerms = Modulus(p).exactTerms() >= saved ? ~uint64_t{0} : 1;
+    CHECK(Tensor::multiplyMod(a, b, Modulus(p)) == expected);
+    Tensor::config::modularDoubleTerms = saved;
+}
+
+int main()
+{
+    // 2^32 - 5 is the largest 32-bit prime; 268435459 is just above the 16-bit split threshold.
+    const uint32_t moduli[] = {2, 7, 65521, 8388593, 268435459, 2147483647u, 4294967291u};
+    const size_t shapes[][3] = {{1, 1, 1}, {3, 5, 7}, {65, 300, 31}, {70, 900, 40}, {7, 70000, 3}};
+    for (uint32_t p : moduli)
+        for (const auto& s : shapes)
+            sameAsNaive<RowMajor>(s[0], s[1], s[2], p);
+    sameAsNaive<ColMajor>(37, 290, 41, 4294967291u);
+    sameAsNaive<Blocked<8>>(37, 290, 41, 65521);
+
+    // Barrett reduction agrees with % across the whole 64-bit range.
+    for (uint32_t p : moduli)
+    {
+        const Modulus modulus(p);
+        bool same = true;
+        for (uint64_t x : {uint64_t{0}, uint64_t{p - 1}, uint64_t{p}, ~uint64_t{0}, ~uint64_t{0} - p, uint64_t{1} << 63})
+            same = same && modulus.reduce(x) == x % p;
+        for (uint64_t x = 12345; x < ~uint64_t{0} / 3; x = (x * 3) + 1)
+            same = same && modulus.reduce(x) == x % p;
+        CHECK(same);
+        CHECK(modulus.lazyTerms() >= 1 && (p > (1u << 26) || modulus.exactTerms() >= 1));
+    }
+
+    CHECK_THROWS(std::invalid_argument, Modulus(1));
+    CHECK_THROWS(std::runtime_error, Tensor::multiplyMod(Mat<uint32_t>(2, 3), Mat<uint32_t>(2, 3), Modulus(7)));
+    return check::result();
+}
@@ -0,0 +1,54 @@
+#include "Check.hpp"
+#include "../PackedTensor.hpp"
+
+#include <cstdint>
+
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+/// Small integers in any type, so every kernel's sums are exact and comparable with ==.
+template<typename T>
+static Mat<T> integers(size_t rows, size_t cols, uint64_t seed)
+{
+    const Mat<int> source = check::random<int>(rows, cols, seed);
+    Mat<T> m(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            m(i, j) = static_cast<T>(source(i, j) / 2);
+    return m;
+}
+
+template<typename T>
+static void packedProducts(size_t m, size_t k, size_t n)
+{
+    const Mat<T> a = integers<T>(m, k, m + k);
+    const Mat<T> b = integers<T>(k, n, k + n);
+    const Mat<T> expected = check::naiveProduct(a, b);
+
+    CHECK(a * b == expected);
+    const Tensor::PackedTensor<T> packed(b);
+    CHECK(packed.rowCount() == k && packed.colCount() == n);
+    CHECK(a * packed == expected);
+    CHECK(a * Tensor::PackedTensor<T>(b.template toLayout<ColMajor>()) == expected);
+    CHECK((a.template toLayout<ColMajor>() * b.template toLayout<ColMajor>()).template toLayout<RowMajor>() == expected);
+
+    // One packing serves any number of left operands.
+    const Mat<T> other = integers<T>(m + 3, k, 99);
+    CHECK(other * packed == check::naiveProduct(other, b));
+    CHECK_THROWS(std::runtime_error, Mat<T>(m, k + 1) * packed);
+}
+
+int main()
+{
+    const size_t shapes[][3] = {{1, 1, 1}, {7, 300, 9}, {100, 100, 100}, {97, 513, 75}, {200, 31, 1100}, {13, 700, 40}};
+    for (const auto& s : shapes)
+    {
+        packedProducts<float>(s[0], s[1], s[2]);
+        packedProducts<double>(s[0], s[1], s[2]);
+        packedProducts<int>(s[0], s[1], s[2]);
+        packedProducts<short>(s[0], s[1], s[2]);
+        packedProducts<int64_t>(s[0], s[1], s[2]);
+    }
+    return check::result();
+}
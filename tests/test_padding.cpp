@@ -0,0 +1,75 @@
+#include "Check.hpp"
+#include "../Factorization.hpp"
+#include "../PackedTensor.hpp"
+
+#include <functional>
+#include <type_traits>
+
+using Tensor::Blocked;
+using Tensor::ColMajor;
+using Tensor::LeadingDim;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+/// A padded tensor behaves exactly like the dense tensor with the same elements.
+template<typename Layout>
+static void sameAsDense()
+{
+    const Mat<double, Layout> a = check::random<double, Layout>(128, 64, 1);
+    const Mat<double, Layout> b = check::random<double, Layout>(128, 64, 2);
+    const size_t extra = std::is_same<Layout, RowMajor>::value ? 3 : std::is_same<Layout, ColMajor>::value ? 5 : 32;
+    Mat<double, Layout> p(128, 64, LeadingDim{Layout::paddedLd(128, 64, sizeof(double)) + extra});
+    for (size_t i = 0; i < 128; ++i)
+        for (size_t j = 0; j < 64; ++j)
+            p(i, j) = a(i, j);
+
+    CHECK(p.leadingDim() != a.leadingDim());
+    CHECK(p == a && a == p && p.allClose(a) && p.maxAbsDiff(a) == 0 && p.maxUlpDistance(a) == 0);
+    CHECK(p.elementWiseOp(b, std::plus<double>()) == a.elementWiseOp(b, std::plus<double>()));
+    CHECK(b.elementWiseOp(p, std::minus<double>()) == b.elementWiseOp(a, std::minus<double>()));
+    CHECK(std::fabs(p.dot(b) - a.dot(b)) < 1e-9 && std::fabs(b.dot(p) - b.dot(a)) < 1e-9);
+    CHECK(std::fabs(p.sum() - a.sum()) < 1e-9);
+    CHECK(p * 2.0 == a * 2.0);
+    CHECK(p.contentHash() == a.contentHash());
+    CHECK(p.transpose() == a.transpose());
+    CHECK(p.compare(b, std::less<double>()) == a.compare(b, std::less<double>()));
+
+    const Mat<double, Layout> at = a.transpose();
+    CHECK((p * at).maxAbsDiff(a * at) < 1e-12);
+    CHECK((at * p).maxAbsDiff(at * a) < 1e-12);
+}
+
+int main()
+{
+    sameAsDense<RowMajor>();
+    sameAsDense<ColMajor>();
+    sameAsDense<Blocked<>>();
+
+    // Padding only where a line is a multiple of 512 bytes, by one cache line.
+    CHECK(RowMajor::paddedLd(1, 1024, 4) == 1040 && RowMajor::paddedLd(1, 1000, 4) == 1000);
+    CHECK(RowMajor::paddedLd(1, 512, 8) == 520 && ColMajor::paddedLd(256, 1, 8) == 264);
+    CHECK(RowMajor::paddedLd(1, 100, 8) == 100);
+    Tensor::config::padLeadingDimension = true;
+    CHECK(Mat<float>(4, 1024).leadingDim() == 1040);
+    Tensor::config::padLeadingDimension = false;
+    CHECK(Mat<float>(4, 1024).leadingDim() == 1024);
+    CHECK_THROWS(std::invalid_argument, Mat<float>(3, 4, LeadingDim{3}));
+    CHECK_THROWS(std::invalid_argument, (Mat<float, Blocked<8>>(3, 4, LeadingDim{12})));
+
+    // Factorizations and packing read through the leading dimension.
+    Mat<double> s = check::random<double>(256, 256, 7);
+    for (size_t i = 0; i < 256; ++i)
+        s(i, i) += 256;
+    Mat<double> sp = Mat<double>::padded(256, 256);
+    CHECK(sp.leadingDim() == 264);
+    for (size_t i = 0; i < 256; ++i)
+        for (size_t j = 0; j < 256; ++j)
+            sp(i, j) = s(i, j);
+    const Mat<double> rhs = check::random<double>(256, 3, 8);
+    CHECK(Tensor::LU<double>(sp).solve(rhs).maxAbsDiff(Tensor::LU<double>(s).solve(rhs)) < 1e-12);
+    CHECK((s * Tensor::PackedTensor<double>(sp)).maxAbsDiff(s * s) < 1e-9);
+
+    // Results derived from a padded tensor keep the padding.
+    CHECK((sp * 2.0).leadingDim() == 264 && (sp * 2.0) == s * 2.0);
+    return check::result();
+}
@@ -0,0 +1,110 @@
+#include "Check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using Tensor::detail::parallelFor;
+using Tensor::detail::parallelReduce;
+
+/// Every index in [0, count) is visited exactly once, whatever the grain.
+static void coverage()
+{
+    for (size_t count : {0, 1, 7, 64, 1000, 4097})
+        for (size_t grain : {1, 3, 64, 5000})
+        {
+            std::vector<std::atomic<int>> visits(count);
+            parallelFor(count, grain, [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                    ++visits[i];
+            });
+            bool once = true;
+            for (const auto& v : visits)
+                once = once && v.load() == 1;
+            CHECK(once);
+        }
+}
+
+/// A throw in any chunk reaches the caller, after every other chunk has finished.
+static void exceptions()
+{
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+    for (size_t failing : {size_t{0}, size_t{999}})   // the caller's own chunk, then a worker's
+    {
+        std::atomic<size_t> done{0};
+        bool caught = false;
+        try
+        {
+            parallelFor(1000, 1, [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    if (i == failing)
+                        throw std::out_of_range("chunk failed");
+                    ++done;
+                }
+            });
+        }
+        catch (const std::out_of_range&)
+        {
+            caught = true;
+        }
+        CHECK(caught);
+        // Chunks other than the failing one ran to the end; nothing runs after the rethrow.
+        const size_t settled = done.load();
+        CHECK(settled >= 500 && settled < 1000);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(done.load() == settled);
+    }
+
+    // Every chunk throws: exactly one exception comes out and the pool keeps working.
+    bool caught = false;
+    try
+    {
+        parallelFor(1000, 1, [](size_t, size_t) { throw std::runtime_error("all"); });
+    }
+    catch (const std::runtime_error&)
+    {
+        caught = true;
+    }
+    CHECK(caught);
+    std::atomic<size_t> after{0};
+    parallelFor(1000, 1, [&](size_t first, size_t last) { after += last - first; });
+    CHECK(after.load() == 1000);
+#endif
+}
+
+static void reductions()
+{
+    std::vector<double> values(100000);
+    check::Values source(9);
+    for (double& v : values)
+        v = source.next();
+    auto leaf = [&](size_t first, size_t last)
+    {
+        double s = 0;
+        for (size_t i = first; i < last; ++i)
+            s += values[i];
+        return s;
+    };
+
+    Tensor::config::deterministic = true;
+    Tensor::config::reductionBlock = 1000;
+    const double serial = parallelReduce<double>(values.size(), 1000, false, leaf);
+    const double parallel = parallelReduce<double>(values.size(), 1000, true, leaf);
+    CHECK(serial == parallel);
+    Tensor::config::deterministic = false;
+    CHECK(std::fabs(parallelReduce<double>(values.size(), 1000, true, leaf) - serial) < 1e-9);
+}
+
+int main()
+{
+    Tensor::config::threadCount = 4;
+    coverage();
+    exceptions();
+    reductions();
+    return check::result();
+}
@@ -0,0 +1,108 @@
+#include "Check.hpp"
+#include "../Random.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using Tensor::Blocked;
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+static bool block(uint64_t key, uint64_t counter, uint64_t b, const uint32_t (&expected)[4])
+{
+    uint32_t out[4];
+    Tensor::detail::Philox(key, counter).block(b, out);
+    return std::equal(out, out + 4, expected);
+}
+
+/// Known-answer vectors of the Random123 reference implementation.
+static void knownAnswers()
+{
+    CHECK(block(0, 0, 0, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    CHECK(block(~0ull, ~0ull, ~0ull, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    CHECK(block(0x299f31d0a4093822ull, 0x0370734413198a2eull, 0x85a308d3243f6a88ull,
+                {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+    // The vector rounds match the scalar ones, across a carry into the counter's high word.
+    const Tensor::detail::Philox rng(123, 7);
+    std::vector<uint32_t> vectorized(4 * 1000), scalar(4 * 1000);
+    rng.blocks(0xFFFFFFF0ull, 1000, vectorized.data());
+    for (size_t i = 0; i < 1000; ++i)
+        rng.block(0xFFFFFFF0ull + i, scalar.data() + (4 * i));
+    CHECK(vectorized == scalar);
+}
+
+static void reproducible()
+{
+    const Mat<double> serial = Tensor::random<double>(300, 301, Tensor::Normal{}, 42);
+    Tensor::config::parallelThreshold = 1000;
+    Tensor::config::threadCount = 4;
+    const Mat<double> parallel = Tensor::random<double>(300, 301, Tensor::Normal{}, 42);
+    CHECK(serial == parallel);
+    CHECK(serial != Tensor::random<double>(300, 301, Tensor::Normal{}, 43));
+    CHECK(serial != Tensor::random<double>(300, 301, Tensor::Normal{}, 42, 1));
+
+    // Samples follow storage order, so a 1 x n row and column-major tensor hold the same sequence.
+    const Mat<float> row = Tensor::random<float>(1, 99, Tensor::Normal{}, 11);
+    const Mat<float, ColMajor> column = Tensor::random<float, ColMajor>(1, 99, Tensor::Normal{}, 11);
+    CHECK(row.toLayout<ColMajor>() == column);
+
+    Mat<float> refilled(1, 99);
+    Tensor::fillRandom(refilled, Tensor::Normal{}, 11);
+    CHECK(refilled == row);
+}
+
+static void distributions()
+{
+    const Mat<double> normal = Tensor::random<double>(1000, 1001, Tensor::Normal{}, 42);
+    double sum = 0, squares = 0;
+    const double n = 1000.0 * 1001.0;
+    for (size_t i = 0; i < 1000; ++i)
+        for (size_t j = 0; j < 1001; ++j)
+        {
+            sum += normal(i, j);
+            squares += normal(i, j) * normal(i, j);
+        }
+    CHECK(std::fabs(sum / n) < 0.01);
+    CHECK(std::fabs((squares / n) - 1) < 0.01);
+
+    const Mat<float, ColMajor> uniform = Tensor::random<float, ColMajor>(513, 77, Tensor::Uniform{-2, 3}, 5);
+    float low = 1e9f, high = -1e9f;
+    sum = 0;
+    for (size_t i = 0; i < 513; ++i)
+        for (size_t j = 0; j < 77; ++j)
+        {
+            low = std::min(low, uniform(i, j));
+            high = std::max(high, uniform(i, j));
+            sum += uniform(i, j);
+        }
+    CHECK(low >= -2 && low < -1.99f && high < 3 && high > 2.99f);
+    CHECK(std::fabs((sum / (513 * 77)) - 0.5) < 0.05);
+
+    const Mat<int> coin = Tensor::random<int>(300, 300, Tensor::Bernoulli{0.3}, 9);
+    size_t ones = 0;
+    bool binary = true;
+    for (size_t i = 0; i < 300; ++i)
+        for (size_t j = 0; j < 300; ++j)
+        {
+            binary = binary && (coin(i, j) == 0 || coin(i, j) == 1);
+            ones += static_cast<size_t>(coin(i, j));
+        }
+    CHECK(binary && std::fabs((static_cast<double>(ones) / 90000) - 0.3) < 0.01);
+
+    const Mat<float, Blocked<>> blocked = Tensor::random<float, Blocked<>>(70, 70, Tensor::Normal{1, 2}, 3);
+    sum = 0;
+    for (size_t i = 0; i < 70; ++i)
+        for (size_t j = 0; j < 70; ++j)
+            sum += blocked(i, j);
+    CHECK(std::fabs((sum / 4900) - 1) < 0.15);
+}
+
+int main()
+{
+    knownAnswers();
+    reproducible();
+    distributions();
+    return check::result();
+}
@@ -0,0 +1,100 @@
+#include "Check.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+using Tensor::Blocked;
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+template<template<typename> class S, typename T, typename Layout>
+static Mat<T, Layout> naive(const Mat<T, Layout>& a, const Mat<T, Layout>& b)
+{
+    Mat<T, Layout> r(a.rowCount(), b.colCount());
+    for (size_t i = 0; i < a.rowCount(); ++i)
+        for (size_t j = 0; j < b.colCount(); ++j)
+        {
+            T acc = S<T>::zero();
+            for (size_t k = 0; k < a.colCount(); ++k)
+                acc = S<T>::add(acc, S<T>::mul(a(i, k), b(k, j)));
+            r(i, j) = acc;
+        }
+    return r;
+}
+
+/// Small non-negative integers (0/1 for the boolean semiring), so every kernel is exact.
+template<template<typename> class S, typename T, typename Layout>
+static Mat<T, Layout> operand(size_t rows, size_t cols, bool padded, uint64_t seed)
+{
+    const bool boolean = std::is_same<S<T>, Tensor::OrAnd<T>>::value;
+    check::Values values(seed);
+    Mat<T, Layout> m = padded ? Mat<T, Layout>::padded(rows, cols) : Mat<T, Layout>(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            m(i, j) = static_cast<T>(std::floor((values.next() + 1) * (boolean ? 1 : 5)));
+    if (!boolean)
+        m(0, 0) = S<T>::zero();   // the semiring's zero must be absorbed, not added
+    return m;
+}
+
+template<template<typename> class S, typename T, typename Layout>
+static void sameAsNaive(size_t m, size_t k, size_t n, bool padded)
+{
+    const Mat<T, Layout> a = operand<S, T, Layout>(m, k, padded, m + k);
+    const Mat<T, Layout> b = operand<S, T, Layout>(k, n, padded, k + n);
+    CHECK(a.template multiply<S>(b) == naive<S>(a, b));
+}
+
+template<typename T, typename Layout>
+static void allSemirings(size_t m, size_t k, size_t n, bool padded = false)
+{
+    sameAsNaive<Tensor::MinPlus, T, Layout>(m, k, n, padded);
+    sameAsNaive<Tensor::MaxPlus, T, Layout>(m, k, n, padded);
+    sameAsNaive<Tensor::MaxTimes, T, Layout>(m, k, n, padded);
+    sameAsNaive<Tensor::OrAnd, T, Layout>(m, k, n, padded);
+    sameAsNaive<Tensor::PlusTimes, T, Layout>(m, k, n, padded);
+}
+
+/// All-pairs shortest paths by repeated min-plus squaring agree with Floyd-Warshall.
+static void shortestPaths()
+{
+    const size_t n = 256;
+    Mat<float> d(n, n);
+    check::Values values(7);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+        {
+            const double v = values.next();
+            d(i, j) = i == j ? 0.0f : v > 0.75 ? std::floor(static_cast<float>(v) * 100) : INFINITY;
+        }
+    Mat<float> floyd = d;
+    for (size_t k = 0; k < n; ++k)
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                floyd(i, j) = std::min(floyd(i, j), floyd(i, k) + floyd(k, j));
+    Mat<float> squared = d;
+    for (size_t step = 1; step < n; step *= 2)
+        squared = squared.multiply<Tensor::MinPlus>(squared);
+    CHECK(squared == floyd);
+}
+
+int main()
+{
+    const size_t shapes[][3] = {{3, 4, 5}, {37, 41, 29}, {130, 300, 70}, {200, 600, 9}};
+    for (const auto& s : shapes)
+    {
+        allSemirings<float, RowMajor>(s[0], s[1], s[2]);
+        allSemirings<double, ColMajor>(s[0], s[1], s[2]);
+        allSemirings<int, RowMajor>(s[0], s[1], s[2]);
+        allSemirings<float, Blocked<16>>(s[0], s[1], s[2]);
+        allSemirings<int, Blocked<8>>(s[0], s[1], s[2]);
+        allSemirings<float, RowMajor>(s[0], s[1], s[2], true);
+    }
+    Tensor::config::deterministic = true;
+    Tensor::config::deterministicKSlice = 300;
+    allSemirings<float, RowMajor>(8, 1000, 300);
+    Tensor::config::deterministic = false;
+    shortestPaths();
+    return check::result();
+}
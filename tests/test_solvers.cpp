@@ -0,0 +1,110 @@
+#include "Check.hpp"
+#include "../Solvers.hpp"
+
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+/// A user operator that replaces y rather than writing into it.
+template<typename T>
+class Assigning : public Tensor::LinearOperator<T>
+{
+private:
+    const Mat<T>& matrix;
+
+public:
+    explicit Assigning(const Mat<T>& a) : matrix(a) {}
+    size_t size() const override { return matrix.rowCount(); }
+    void apply(const Mat<T>& x, Mat<T>& y) const override { y = matrix * x; }
+};
+
+/// max |A x - b|.
+template<typename T, typename Layout>
+static double residual(const Mat<T, Layout>& a, const Mat<T>& x, const Mat<T>& b)
+{
+    const Mat<T> ax = a.template toLayout<RowMajor>() * x;
+    return check::maxDiff(ax, b);
+}
+
+template<typename T>
+static void solves(size_t n)
+{
+    const double tolerance = sizeof(T) == sizeof(float) ? 1e-3 : 1e-8;
+    Tensor::SolverOptions options;
+    options.tolerance = sizeof(T) == sizeof(float) ? 1e-5 : 1e-10;
+    const Mat<T> b = check::random<T>(n, 1, 2);
+
+    // Symmetric positive definite: m m^T + n I.
+    const Mat<T> m = check::random<T>(n, n, 1);
+    Mat<T> spd = m * m.transpose();
+    for (size_t i = 0; i < n; ++i)
+        spd(i, i) += static_cast<T>(n);
+    const Tensor::MatrixOperator<T> op(spd);
+    Mat<T> x(n, 1);
+    Tensor::SolverResult r = Tensor::conjugateGradient<T>(op, b, x, options);
+    CHECK(r.converged && r.iterations <= n + 1 && residual(spd, x, b) < tolerance);
+
+    const Tensor::JacobiPreconditioner<T> jacobi(spd);
+    x.fill(0);
+    r = Tensor::conjugateGradient<T>(op, b, x, options, &jacobi);
+    CHECK(r.converged && residual(spd, x, b) < tolerance);
+
+    // Operators on other layouts, and ones that assign to y, keep CG's vectors valid.
+    const Mat<T, ColMajor> spdColumns = spd.template toLayout<ColMajor>();
+    const Tensor::MatrixOperator<T, ColMajor> spdColumnOp(spdColumns);
+    x.fill(0);
+    r = Tensor::conjugateGradient<T>(spdColumnOp, b, x, options);
+    CHECK(r.converged && residual(spdColumns, x, b) < tolerance);
+    x.fill(0);
+    r = Tensor::conjugateGradient<T>(spdColumnOp, b, x, options, &jacobi);
+    CHECK(r.converged && residual(spdColumns, x, b) < tolerance);
+    const Assigning<T> assigning(spd);
+    x.fill(0);
+    r = Tensor::conjugateGradient<T>(assigning, b, x, options, &jacobi);
+    CHECK(r.converged && residual(spd, x, b) < tolerance);
+
+    // Non-symmetric, diagonally dominant.
+    Mat<T> general = check::random<T>(n, n, 3);
+    for (size_t i = 0; i < n; ++i)
+        general(i, i) += static_cast<T>(n) / 4;
+    options.restart = 10;
+    const Tensor::MatrixOperator<T> generalOp(general);
+    x.fill(0);
+    r = Tensor::gmres<T>(generalOp, b, x, options);
+    CHECK(r.converged && residual(general, x, b) < tolerance);
+
+    const Tensor::JacobiPreconditioner<T> generalJacobi(general);
+    x.fill(0);
+    r = Tensor::gmres<T>(generalOp, b, x, options, &generalJacobi);
+    CHECK(r.converged && residual(general, x, b) < tolerance);
+
+    const Mat<T, ColMajor> columns = general.template toLayout<ColMajor>();
+    const Tensor::MatrixOperator<T, ColMajor> columnOp(columns);
+    x.fill(0);
+    r = Tensor::gmres<T>(columnOp, b, x, options);
+    CHECK(r.converged && residual(columns, x, b) < tolerance);
+
+    // A zero right-hand side is solved by x = 0 without iterating.
+    x.fill(1);
+    r = Tensor::conjugateGradient<T>(op, Mat<T>(n, 1), x, options);
+    CHECK(r.converged && x.norm() == T{0});
+}
+
+static void mismatches()
+{
+    const Mat<double> a(3, 3);
+    const Tensor::MatrixOperator<double> op(a);
+    Mat<double> x(3, 1);
+    CHECK_THROWS(std::runtime_error, Tensor::conjugateGradient<double>(op, Mat<double>(4, 1), x));
+    CHECK_THROWS(std::invalid_argument, Tensor::gmres<double>(op, Mat<double>(3, 2), x));
+}
+
+int main()
+{
+    solves<double>(200);
+    solves<float>(67);
+    solves<double>(3);
+    solves<double>(8);
+    mismatches();
+    return check::result();
+}
@@ -0,0 +1,112 @@
+#include "Check.hpp"
+
+#include <limits>
+#include <vector>
+
+using Tensor::ColMajor;
+using Tensor::RowMajor;
+template<typename T, typename Layout = RowMajor> using Mat = Tensor::Tensor<T, Layout>;
+
+namespace
+{
+    size_t products = 0;
+}
+
+static void observe(const Tensor::GemmDecision&) { ++products; }
+
+/// Elements equal, or both NaN.
+template<typename Layout>
+static bool sameOrNaN(const Mat<double, Layout>& a, const Mat<double, Layout>& b, double tolerance)
+{
+    for (size_t i = 0; i < a.rowCount(); ++i)
+        for (size_t j = 0; j < a.colCount(); ++j)
+            if (std::isnan(a(i, j)) != std::isnan(b(i, j)) || (!std::isnan(a(i, j)) && std::fabs(a(i, j) - b(i, j)) > tolerance))
+                return false;
+    return true;
+}
+
+/// Off by default: products multiply every element, so 0 * inf reaches the result as NaN.
+template<typename Layout>
+static void ieeeByDefault()
+{
+    const size_t n = 40;
+    Mat<double, Layout> b = check::random<double, Layout>(n, n, 1);
+    b(3, 5) = std::numeric_limits<double>::infinity();
+    b(7, 2) = std::numeric_limits<double>::quiet_NaN();
+    const Mat<double, Layout> id = Mat<double, Layout>::eye(n);
+    const Mat<double, Layout> expected = check::naiveProduct(id, b);
+    CHECK(std::isnan(expected(0, 5)) && std::isnan(expected(0, 2)));
+
+    CHECK(!Tensor::config::structuredProducts);
+    products = 0;
+    CHECK(sameOrNaN(id * b, expected, 0) && sameOrNaN(b * id, check::naiveProduct(b, id), 0));
+    CHECK(products == 2);
+}
+
+/// Opted in: recorded structure short-cuts the product, and matches it wherever no inf or NaN is involved.
+template<typename Layout>
+static void shortcuts()
+{
+    const size_t n = 300;
+    const Mat<double, Layout> b = check::random<double, Layout>(n, n, 2);
+    std::vector<double> d(n);
+    for (size_t i = 0; i < n; ++i)
+        d[i] = static_cast<double>(i % 7) - 3;
+    const Mat<double, Layout> id = Mat<double, Layout>::eye(n);
+    const Mat<double, Layout> diagonal = Mat<double, Layout>::diag(d);
+    const Mat<double, Layout> zero = Mat<double, Layout>::diag(std::vector<double>(n, 0.0));
+    Mat<double, Layout> lower = check::random<double, Layout>(n, n, 3);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = i + 1; j < n; ++j)
+            lower(i, j) = 0;
+
+    Tensor::config::structuredProducts = true;
+    products = 0;
+    CHECK(id * b == b && b * id == b);
+    CHECK(check::maxDiff(diagonal * b, check::naiveProduct(diagonal, b)) == 0);
+    CHECK(check::maxDiff(b * diagonal, check::naiveProduct(b, diagonal)) == 0);
+    const Mat<double, Layout> zeros(n, n);
+    CHECK(zero * b == zeros && b * zero == zeros);
+    CHECK(products == 0);
+
+    // Never scanned: an unrecorded triangular operand takes the general product.
+    CHECK(check::maxDiff(lower * b, check::naiveProduct(lower, b)) < 1e-10);
+    CHECK(products == 1 && lower.isLowerTriangular());
+    lower.detectStructure();
+    products = 0;
+    CHECK(check::maxDiff(lower * b, check::naiveProduct(lower, b)) < 1e-10);
+    CHECK(check::maxDiff(b * lower, check::naiveProduct(b, lower)) < 1e-10);
+    const Mat<double, Layout> upper = lower.transpose();
+    CHECK(check::maxDiff(upper * b, check::naiveProduct(upper, b)) < 1e-10);
+    CHECK(products > 0 && upper.isUpperTriangular());
+
+    // A write drops the record.
+    Mat<double, Layout> changed = id;
+    changed(0, 1) = 2;
+    products = 0;
+    CHECK(check::maxDiff(changed * b, check::naiveProduct(changed, b)) < 1e-12 && products == 1);
+
+    // A hand-built identity isn't known to be one until detectStructure().
+    Mat<double, Layout> built(n, n);
+    for (size_t i = 0; i < n; ++i)
+        built(i, i) = 1;
+    products = 0;
+    CHECK(built * b == b && products == 1 && built.isIdentity());
+    built.detectStructure();
+    CHECK(built * b == b && products == 1);
+
+    Mat<double, Layout> into(n, n);
+    id.multiplyInto(b, into);
+    CHECK(into == b && products == 1);
+    Tensor::config::structuredProducts = false;
+}
+
+int main()
+{
+    Tensor::config::gemmObserver = observe;
+    ieeeByDefault<RowMajor>();
+    ieeeByDefault<ColMajor>();
+    shortcuts<RowMajor>();
+    shortcuts<ColMajor>();
+    return check::result();
+}
@@ -0,0 +1,41 @@
+#include "Check.hpp"
+
+#include <functional>
+
+using Tensor::ErrorCode;
+template<typename T> using Mat = Tensor::Tensor<T>;
+
+/// The try* API reports the error the throwing API would raise, in C++17 and C++23 alike.
+int main()
+{
+    auto created = Mat<double>::tryCreate(2, 3);
+    CHECK(created.has_value() && created->rowCount() == 2 && (*created).colCount() == 3);
+    auto empty = Mat<double>::tryCreate(0, 3);
+    CHECK(!empty && empty.error() == ErrorCode::ZeroSize);
+
+    Mat<double> a = check::random<double>(2, 3);
+    CHECK(a.tryAt(1, 2).value() == a(1, 2));
+    CHECK(!a.tryAt(2, 0) && a.tryAt(2, 0).error() == ErrorCode::OutOfRange);
+    CHECK(a.tryAt(0, 9).value_or(-1.0) == -1.0);
+    CHECK(a.trySet(0, 1, 7.0).has_value() && a(0, 1) == 7.0);
+    CHECK(a.trySet(0, 3, 7.0).error() == ErrorCode::OutOfRange);
+
+    CHECK(a.tryElementWiseOp(a, std::plus<double>()).value() == a * 2.0);
+    CHECK(a.tryElementWiseOp(Mat<double>(3, 2), std::plus<double>()).error() == ErrorCode::SizeMismatch);
+
+    const Mat<double> b = check::random<double>(3, 4, 2);
+    CHECK(check::maxDiff(a.tryMultiply(b).value(), check::naiveProduct(a, b)) < 1e-12);
+    CHECK(a.tryMultiply(a).error() == ErrorCode::IncompatibleDimensions);
+
+    Mat<double> c(2, 4);
+    CHECK(a.tryMultiplyInto(b, c) && check::maxDiff(c, check::naiveProduct(a, b)) < 1e-12);
+    Mat<double> square = check::random<double>(3, 3, 3);
+    CHECK(square.tryMultiplyInto(square, square).error() == ErrorCode::AliasedResult);
+    CHECK(a.tryMultiplyInto(b, square).error() == ErrorCode::IncompatibleDimensions);
+
+    Tensor::Result<void> failed = Tensor::failure(ErrorCode::SizeMismatch);
+    CHECK(!failed.has_value());
+    CHECK_THROWS(std::exception, a.tryAt(5, 5).value());
+    CHECK(std::string(Tensor::describe(ErrorCode::SizeMismatch)) == "Size mismatch");
+    return check::result();
+}